@@ -1,10 +1,31 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <map>
 
 #include "VNVita\Commands.h"
 #include "VNVita\Visitors.h"
+#include "VNVita\Analysis.h"
+#include "VNVita\Passes.h"
+#include "VNVita\Output.h"
 #include "VNVita\CharReaders.h"
 #include "VNVita\Parser.h"
+#include "VNVita\Script.h"
+#include "VNVita\Novel.h"
+#include "VNVita\Parallel.h"
+#include "VNVita\Runtime.h"
+#include "VNVita\Search.h"
+#include "VNVita\Translation.h"
+#include "VNVita\IO.h"
 #include "VNVita\ParseException.h"
 
 //
@@ -23,21 +44,208 @@
 //  limitations under the License.
 //
 
-void processFile(std::string path);
+VNVita::Script loadScript(std::string path);
+
+struct ConversionOptions
+{
+	int optimisationLevel = 0;
+
+	// Only the vnvita format is formatted in parallel
+	std::size_t formatThreadCount = 1;
+
+	VNVita::OutputFormat outputFormat = VNVita::OutputFormat::VNVita;
+};
+
+enum class ChangeResult : std::uint8_t
+{
+	Converted,
+	Unchanged,
+
+	// Already reported, nothing was converted
+	Failed,
+};
+
+VNVita::Script processFile(std::string path, const ConversionOptions & options);
+ChangeResult processChangedFile(const std::string & path, const ConversionOptions & options, VNVita::BuildManifest & buildManifest, VNVita::Script & script);
+void convertFiles(const std::vector<std::string> & paths, const ConversionOptions & options, VNVita::FileIO & fileIO, std::vector<VNVita::Script> & scripts);
+void reportUnresolvedTargets(const std::vector<VNVita::Script> & scripts);
+bool tryParseSize(const std::string & text, std::size_t & result);
+int play(int argumentCount, const char * arguments[]);
+int explore(int argumentCount, const char * arguments[]);
+int manifest(int argumentCount, const char * arguments[]);
+int graph(int argumentCount, const char * arguments[]);
+int index(int argumentCount, const char * arguments[]);
+int search(int argumentCount, const char * arguments[]);
+int extract(int argumentCount, const char * arguments[]);
+int inject(int argumentCount, const char * arguments[]);
+int stats(int argumentCount, const char * arguments[]);
+int ioBenchmark(int argumentCount, const char * arguments[]);
+
+void printUsage()
+{
+	std::cout << "Usage: VNDSReader [-O1|-O2] [--threads <n>] [--format vnvita|jsonl|binary] [--build-manifest <file> | --io stream|uring] <path> ...\n";
+	std::cout << "       VNDSReader --play [--seed <n>] [--choices <i,j,...>] [--runs <n>] [--threads <n>] <path> ...\n";
+	std::cout << "       VNDSReader --explore [--threads <n>] [--states <n>] <path> ...\n";
+	std::cout << "       VNDSReader --manifest [--root <novel directory>] <path> ...\n";
+	std::cout << "       VNDSReader --graph [--entry <script>] <path> ...\n";
+	std::cout << "       VNDSReader --index <index file> <path> ...\n";
+	std::cout << "       VNDSReader --search <index file> <text>\n";
+	std::cout << "       VNDSReader --extract <path> ...\n";
+	std::cout << "       VNDSReader --inject <output directory> <path> ...\n";
+	std::cout << "       VNDSReader --stats <path> ...\n";
+	std::cout << "       VNDSReader --io-benchmark [--rounds <n>] <path> ...\n";
+}
 
 int main(int argumentCount, const char * arguments[])
 {
-	if(argumentCount < 1)
+	if(argumentCount < 2)
 	{
-		std::cout << "Usage: VNDSReader <path> ...\n";
+		printUsage();
 		return EXIT_FAILURE;
 	}
 
-	for(int index = 0; index < argumentCount; ++index)
+	if(std::string(arguments[1]) == "--play")
+		return play(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--explore")
+		return explore(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--manifest")
+		return manifest(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--graph")
+		return graph(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--index")
+		return index(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--search")
+		return search(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--extract")
+		return extract(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--inject")
+		return inject(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--stats")
+		return stats(argumentCount, arguments);
+
+	if(std::string(arguments[1]) == "--io-benchmark")
+		return ioBenchmark(argumentCount, arguments);
+
+	std::vector<VNVita::Script> scripts;
+	ConversionOptions options;
+
+	std::string buildManifestPath;
+	VNVita::BuildManifest buildManifest;
+	std::size_t unchangedCount = 0;
+
+	// With --io every path is read first, then converted at once
+	bool isBatched = false;
+	VNVita::FileIOBackend fileIOBackend = VNVita::FileIOBackend::Stream;
+	std::vector<std::string> batchedPaths;
+
+	// Skip the program path
+	for(int index = 1; index < argumentCount; ++index)
 	{
+		const std::string argument = arguments[index];
+
+		if((argument == "-O0") || (argument == "-O1") || (argument == "-O2"))
+		{
+			options.optimisationLevel = (argument[2] - '0');
+			continue;
+		}
+
+		if(argument == "--threads")
+		{
+			if(((index + 1) >= argumentCount) || !tryParseSize(arguments[index + 1], options.formatThreadCount))
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+
+			++index;
+			continue;
+		}
+
+		if(argument == "--format")
+		{
+			if(((index + 1) >= argumentCount) || !VNVita::tryParseOutputFormat(arguments[index + 1], options.outputFormat))
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+
+			++index;
+			continue;
+		}
+
+		if(argument == "--build-manifest")
+		{
+			if((index + 1) >= argumentCount)
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+
+			if(isBatched)
+			{
+				std::cerr << "Error: --build-manifest can't be used with --io\n";
+				return EXIT_FAILURE;
+			}
+
+			buildManifestPath = arguments[++index];
+
+			if(!buildManifest.tryLoad(buildManifestPath))
+			{
+				std::cerr << "Error: " << buildManifestPath << " is not a build manifest\n";
+				return EXIT_FAILURE;
+			}
+
+			continue;
+		}
+
+		if(argument == "--io")
+		{
+			if(((index + 1) >= argumentCount) || !VNVita::tryParseFileIOBackend(arguments[index + 1], fileIOBackend))
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+
+			if(!buildManifestPath.empty())
+			{
+				std::cerr << "Error: --io can't be used with --build-manifest\n";
+				return EXIT_FAILURE;
+			}
+
+			isBatched = true;
+			++index;
+			continue;
+		}
+
+		if(isBatched)
+		{
+			batchedPaths.push_back(argument);
+			continue;
+		}
+
 		try
 		{
-			processFile(arguments[index]);
+			if(buildManifestPath.empty())
+			{
+				scripts.push_back(processFile(argument, options));
+				continue;
+			}
+
+			VNVita::Script script;
+			const ChangeResult result = processChangedFile(argument, options, buildManifest, script);
+
+			if(result == ChangeResult::Converted)
+				scripts.push_back(std::move(script));
+			else if(result == ChangeResult::Unchanged)
+				++unchangedCount;
 		}
 		catch(VNVita::ParseException & exception)
 		{
@@ -45,6 +253,28 @@ int main(int argumentCount, const char * arguments[])
 		}
 	}
 
+	if(isBatched)
+	{
+		const auto fileIO = VNVita::makeFileIO(fileIOBackend);
+
+		if((fileIOBackend == VNVita::FileIOBackend::IoUring) && (std::string(fileIO->getName()) != "io_uring"))
+			std::cerr << "Warning: io_uring is not available, using " << fileIO->getName() << '\n';
+
+		convertFiles(batchedPaths, options, *fileIO, scripts);
+	}
+
+	if(!buildManifestPath.empty())
+	{
+		std::cout << scripts.size() << " converted, " << unchangedCount << " unchanged\n";
+
+		if(!buildManifest.trySave(buildManifestPath))
+			std::cerr << "Error: could not write " << buildManifestPath << '\n';
+	}
+
+	// Jumps into scripts that weren't loaded would look unresolved
+	if(unchangedCount == 0)
+		reportUnresolvedTargets(scripts);
+
 	return EXIT_SUCCESS;
 }
 
@@ -81,11 +311,14 @@ std::vector<std::shared_ptr<VNVita::Command>> filterErroneousCommands(const std:
 {
 	using VNVita::Command;
 	using VNVita::IfCommand;
-	using VNVita::FiCommand;
-	
-	std::vector<std::shared_ptr<Command>> commands;
+	using VNVita::IfBlockTable;
+	using VNVita::isa;
+
+	// Match every if to its fi up front so an erroneous block,
+	// including any blocks nested in it, can be dropped in one step
+	const IfBlockTable blocks(results);
 
-	bool isInErroneousIfBlock = false;
+	std::vector<std::shared_ptr<Command>> commands;
 
 	for(std::size_t index = 0; index < results.size(); ++index)
 	{
@@ -94,19 +327,16 @@ std::vector<std::shared_ptr<VNVita::Command>> filterErroneousCommands(const std:
 		if(result.getCommand() == nullptr)
 			continue;
 
-		if(isInErroneousIfBlock)
-		{
-			const auto commandPointer = result.getCommand().get();
-			const auto command = dynamic_cast<FiCommand *>(commandPointer);
-			if(command != nullptr)
-				isInErroneousIfBlock = false;
-		}
-		else if(result.hasException())
+		if(result.hasException())
 		{
-			const auto commandPointer = result.getCommand().get();
-			const auto command = dynamic_cast<IfCommand *>(commandPointer);
-			if(command != nullptr)
-				isInErroneousIfBlock = true;
+			if(isa<IfCommand>(*result.getCommand()))
+			{
+				std::size_t fiIndex;
+				if(!blocks.tryGetMatchingFi(index, fiIndex))
+					break;
+
+				index = fiIndex;
+			}
 		}
 		else
 		{
@@ -117,15 +347,12 @@ std::vector<std::shared_ptr<VNVita::Command>> filterErroneousCommands(const std:
 	return commands;
 }
 
-void processFile(std::string path)
+VNVita::Script parseScript(const std::string & path, std::istream & input)
 {
 	using namespace VNVita;
 
-	// Open input file
-	std::ifstream inputFile(path);
-
 	// Create parser
-	Parser parser(std::make_shared<IStreamCharReader>(inputFile));
+	Parser parser(std::make_shared<IStreamCharReader>(input));
 	
 	// Read commands into vector
 	auto results = readResults(parser);
@@ -133,18 +360,1293 @@ void processFile(std::string path)
 	// Filter the commands
 	auto commands = filterErroneousCommands(results);
 
+	// Build the script's block and label tables
+	return Script(path, std::move(commands));
+}
+
+VNVita::Script loadScript(std::string path)
+{
+	// Open input file
+	std::ifstream inputFile(path);
+
+	return parseScript(path, inputFile);
+}
+
+VNVita::Script optimiseScript(VNVita::Script script, int optimisationLevel, std::ostream & reportOutput)
+{
+	using namespace VNVita;
+
+	if(optimisationLevel <= 0)
+		return script;
+
+	// Shrink the commands
+	auto commands = script.getCommands();
+	const auto reports = PassPipeline(optimisationLevel).run(commands);
+
+	for(const auto & report : reports)
+		reportOutput << script.getName() << ": " << report.name << " removed " << report.removedCount << '\n';
+
+	return VNVita::Script(script.getPath(), std::move(commands));
+}
+
+void writeOutput(const VNVita::Script & script, const ConversionOptions & options, std::ostream & output)
+{
+	using namespace VNVita;
+
+	// Format commands, split across threads if asked for
+	if((options.outputFormat == OutputFormat::VNVita) && (options.formatThreadCount > 1))
+	{
+		ParallelCommandFormatter(options.formatThreadCount).format(script.getCommands(), output);
+		return;
+	}
+
+	// Create formatter
+	const auto formatter = makeOutputVisitor(options.outputFormat, output);
+
+	// Format commands
+	for(const auto & command : script.getCommands())
+		formatter->visit(*command);
+}
+
+std::ios::openmode getOutputMode(const ConversionOptions & options)
+{
+	return VNVita::isBinaryOutputFormat(options.outputFormat) ? (std::ios::out | std::ios::binary) : std::ios::out;
+}
+
+// For reading back an output written with getOutputMode
+std::ios::openmode getInputMode(const ConversionOptions & options)
+{
+	return VNVita::isBinaryOutputFormat(options.outputFormat) ? (std::ios::in | std::ios::binary) : std::ios::in;
+}
+
+VNVita::Script processFile(std::string path, const ConversionOptions & options)
+{
+	using namespace VNVita;
+
+	Script script = optimiseScript(loadScript(path), options.optimisationLevel, std::cout);
+
 	// Get output file path
 	std::string outputPath;
-	if(!tryReplaceFileExtension(path, outputPath, ".vnvita"))
-		return;
+	if(!tryReplaceFileExtension(path, outputPath, getOutputExtension(options.outputFormat)))
+		return script;
 
 	// Open output file
-	std::ofstream outputFile(outputPath);
+	std::ofstream outputFile(outputPath, getOutputMode(options));
 
-	// Create formatter
-	CommandFormatVisitor formatter(outputFile);
+	writeOutput(script, options, outputFile);
 
-	// Format commands
-	for(const auto & command : commands)
-		formatter.visit(*command);
+	return script;
+}
+
+bool tryReadFile(const std::string & path, std::ios::openmode mode, std::string & content)
+{
+	std::ifstream file(path, mode);
+
+	if(!file)
+		return false;
+
+	content.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return !file.bad();
+}
+
+// The options that change what a file converts to
+std::string getOutputSettings(const ConversionOptions & options)
+{
+	return ("O" + std::to_string(options.optimisationLevel) + ',' + VNVita::getOutputFormatName(options.outputFormat));
+}
+
+// Like processFile, but returns Unchanged without parsing if the file
+// and the output settings are the same as when the manifest last
+// saw it and its output is still there. An output that comes out
+// the same as the one on disk isn't written again either, so its
+// modification time only changes when its content does.
+//
+// A file that can't be read or written gets no record, so the next
+// build tries it again.
+ChangeResult processChangedFile(const std::string & path, const ConversionOptions & options, VNVita::BuildManifest & buildManifest, VNVita::Script & script)
+{
+	using namespace VNVita;
+
+	std::string outputPath;
+	if(!tryReplaceFileExtension(path, outputPath, getOutputExtension(options.outputFormat)))
+	{
+		script = processFile(path, options);
+		return ChangeResult::Converted;
+	}
+
+	// Read the same way loadScript does
+	std::string input;
+	if(!tryReadFile(path, std::ios::in, input))
+	{
+		std::cerr << "Error: could not read " << path << '\n';
+		return ChangeResult::Failed;
+	}
+
+	const BuildRecord * record = buildManifest.tryGetRecord(path);
+	const std::uint64_t inputHash = BuildManifest::hash(input);
+	const std::string settings = getOutputSettings(options);
+
+	const bool isSameBuild = (record != nullptr) && (record->settings == settings);
+	const bool hasOutput = static_cast<bool>(std::ifstream(outputPath));
+
+	if(isSameBuild && (record->inputHash == inputHash) && hasOutput)
+		return ChangeResult::Unchanged;
+
+	std::istringstream inputStream(input);
+	script = optimiseScript(parseScript(path, inputStream), options.optimisationLevel, std::cout);
+
+	std::ostringstream outputStream(getOutputMode(options));
+	writeOutput(script, options, outputStream);
+
+	const std::string output = outputStream.str();
+	const std::uint64_t outputHash = BuildManifest::hash(output);
+
+	// Without a record, what's on disk has to be read to be compared
+	bool isUnchanged = isSameBuild && (record->outputHash == outputHash) && hasOutput;
+
+	std::string existing;
+	if(!isUnchanged && hasOutput && tryReadFile(outputPath, getInputMode(options), existing))
+		isUnchanged = (existing == output);
+
+	if(!isUnchanged)
+	{
+		std::ofstream outputFile(outputPath, getOutputMode(options));
+		outputFile.write(output.data(), static_cast<std::streamsize>(output.size()));
+		outputFile.close();
+
+		// The script still counts as converted, as it does in convertFiles
+		if(!outputFile)
+		{
+			std::cerr << "Error: could not write " << outputPath << '\n';
+			return ChangeResult::Converted;
+		}
+	}
+
+	buildManifest.setRecord(path, BuildRecord { inputHash, outputHash, settings });
+	return ChangeResult::Converted;
+}
+
+struct ConvertedFile
+{
+	VNVita::Script script;
+	std::string output;
+	bool isConverted = false;
+
+	// Printed in the order of the paths once every file is done
+	std::string reports;
+	std::string errors;
+};
+
+// Like processFile for every path, but fileIO reads and writes the files
+// in batches. A thread for each core parses and formats every file as
+// soon as its read completes, while the rest are still being read.
+void convertFiles(const std::vector<std::string> & paths, const ConversionOptions & options, VNVita::FileIO & fileIO, std::vector<VNVita::Script> & scripts)
+{
+	using namespace VNVita;
+
+	ReadQueue queue;
+	std::vector<ConvertedFile> files(paths.size());
+
+	const auto worker = [&]()
+	{
+		FileRead read;
+
+		while(queue.tryPop(read))
+		{
+			const std::string & path = paths[read.index];
+			ConvertedFile & file = files[read.index];
+
+			if(!read.isRead)
+			{
+				file.errors = ("Error: could not read " + path + '\n');
+				continue;
+			}
+
+			try
+			{
+				std::istringstream input(read.content);
+				std::ostringstream reports;
+				file.script = optimiseScript(parseScript(path, input), options.optimisationLevel, reports);
+
+				std::ostringstream output(getOutputMode(options));
+				writeOutput(file.script, options, output);
+
+				file.output = output.str();
+				file.reports = reports.str();
+				file.isConverted = true;
+			}
+			catch(ParseException & exception)
+			{
+				file.errors = (std::string("Error: ") + exception.what() + '\n');
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for(std::size_t index = VNVita::getThreadCount(0); index > 0; --index)
+		threads.emplace_back(worker);
+
+	fileIO.readFiles(paths, queue);
+	queue.close();
+
+	for(auto & thread : threads)
+		thread.join();
+
+	std::vector<FileWrite> writes;
+	std::vector<std::size_t> writeIndices;
+
+	for(std::size_t index = 0; index < files.size(); ++index)
+	{
+		std::string outputPath;
+		if(!files[index].isConverted || !tryReplaceFileExtension(paths[index], outputPath, getOutputExtension(options.outputFormat)))
+			continue;
+
+		writes.push_back(FileWrite { outputPath, std::move(files[index].output), isBinaryOutputFormat(options.outputFormat), false });
+		writeIndices.push_back(index);
+	}
+
+	fileIO.writeFiles(writes);
+
+	for(std::size_t index = 0; index < writes.size(); ++index)
+		if(!writes[index].isWritten)
+			files[writeIndices[index]].errors += ("Error: could not write " + writes[index].path + '\n');
+
+	for(auto & file : files)
+	{
+		std::cout << file.reports;
+		std::cerr << file.errors;
+
+		if(file.isConverted)
+			scripts.push_back(std::move(file.script));
+	}
+}
+
+void reportUnresolvedTargets(const std::vector<VNVita::Script> & scripts)
+{
+	using namespace VNVita;
+
+	// Resolve every goto against its own script
+	for(const auto & script : scripts)
+		for(const auto & command : script.getCommands())
+		{
+			const auto gotoCommand = tryCast<GoToCommand>(command.get());
+			if((gotoCommand != nullptr) && !script.getLabels().contains(gotoCommand->getLabel()))
+				std::cerr << "Warning: " << script.getPath() << ": goto to unknown label " << gotoCommand->getLabel() << '\n';
+		}
+
+	// Resolve every jump across the whole set of scripts
+	const JumpTable jumpTable(scripts);
+
+	for(const auto & target : jumpTable.getTargets())
+	{
+		if(target.isResolved())
+			continue;
+
+		const auto & script = scripts[target.sourceScript];
+		const auto & jumpCommand = cast<JumpCommand>(script.getCommand(target.sourceIndex));
+
+		std::cerr << "Warning: " << script.getPath() << ": jump to ";
+
+		if(target.state == JumpTargetState::MissingScript)
+			std::cerr << "unknown script " << jumpCommand.getPath() << '\n';
+		else
+			std::cerr << "unknown label " << jumpCommand.getLabel() << " in " << jumpCommand.getPath() << '\n';
+	}
+}
+
+bool tryParseSize(const std::string & text, std::size_t & result)
+{
+	if(text.empty() || (text.find_first_not_of("0123456789") != std::string::npos))
+		return false;
+
+	// Digits alone can still be too many for the type
+	try
+	{
+		const unsigned long long value = std::stoull(text);
+
+		if(value > static_cast<unsigned long long>(static_cast<std::size_t>(-1)))
+			return false;
+
+		result = static_cast<std::size_t>(value);
+		return true;
+	}
+	catch(...)
+	{
+		return false;
+	}
+}
+
+bool tryParseChoices(const std::string & text, std::vector<std::size_t> & result)
+{
+	std::istringstream stream(text);
+
+	std::string item;
+	while(std::getline(stream, item, ','))
+	{
+		std::size_t choice;
+		if(!tryParseSize(item, choice))
+			return false;
+
+		result.push_back(choice);
+	}
+
+	return true;
+}
+
+// Parses the scripts in parallel, keeping them in the order given
+bool tryLoadScripts(const std::vector<std::string> & paths, std::vector<VNVita::Script> & scripts)
+{
+	std::vector<VNVita::Script> loaded(paths.size());
+	std::vector<std::string> errors(paths.size());
+
+	VNVita::forEachInParallel(paths.size(), 0, [&](std::size_t index)
+	{
+		try
+		{
+			loaded[index] = loadScript(paths[index]);
+		}
+		catch(VNVita::ParseException & exception)
+		{
+			errors[index] = exception.what();
+		}
+	});
+
+	bool isLoaded = true;
+
+	for(const auto & error : errors)
+		if(!error.empty())
+		{
+			std::cerr << "Error: " << error << '\n';
+			isLoaded = false;
+		}
+
+	if(isLoaded)
+		scripts = std::move(loaded);
+
+	return isLoaded;
+}
+
+const char * getStateName(VNVita::EngineState state)
+{
+	using VNVita::EngineState;
+
+	switch(state)
+	{
+	case EngineState::Running:
+		return "running";
+	case EngineState::AwaitingInput:
+		return "awaiting-input";
+	case EngineState::Delaying:
+		return "delaying";
+	case EngineState::AwaitingChoice:
+		return "awaiting-choice";
+	case EngineState::AwaitingRandom:
+		return "awaiting-random";
+	case EngineState::Finished:
+		return "finished";
+	case EngineState::Faulted:
+		return "faulted";
+	default:
+		return "unknown";
+	}
+}
+
+// Runs the novel made of the given scripts headless, starting at the first.
+// A single run prints its log, several runs print a throughput summary.
+int play(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	PlaythroughOptions options;
+	std::size_t runCount = 1;
+	std::size_t threadCount = 0;
+	std::vector<std::string> paths;
+
+	// Skip the program path and --play
+	for(int index = 2; index < argumentCount; ++index)
+	{
+		const std::string argument = arguments[index];
+
+		if((argument.compare(0, 2, "--") == 0) && ((index + 1) >= argumentCount))
+		{
+			printUsage();
+			return EXIT_FAILURE;
+		}
+
+		bool isValid = true;
+		std::size_t value = 0;
+
+		if(argument == "--seed")
+		{
+			isValid = tryParseSize(arguments[++index], value);
+			options.seed = static_cast<std::uint32_t>(value);
+		}
+		else if(argument == "--choices")
+		{
+			isValid = tryParseChoices(arguments[++index], options.choices);
+			options.choicePolicy = ChoicePolicy::Scripted;
+		}
+		else if(argument == "--runs")
+		{
+			isValid = tryParseSize(arguments[++index], runCount);
+		}
+		else if(argument == "--threads")
+		{
+			isValid = tryParseSize(arguments[++index], threadCount);
+		}
+		else
+		{
+			paths.push_back(argument);
+		}
+
+		if(!isValid)
+		{
+			std::cerr << "Error: invalid value for " << argument << '\n';
+			return EXIT_FAILURE;
+		}
+	}
+
+	if(paths.empty())
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Script> scripts;
+	if(!tryLoadScripts(paths, scripts))
+		return EXIT_FAILURE;
+
+	const Novel novel(std::move(scripts));
+
+	if(runCount > 1)
+	{
+		const auto batch = runPlaythroughs(novel, options, runCount, threadCount);
+
+		std::cout << "runs " << batch.runCount << '\n';
+		std::cout << "distinct " << batch.distinctDigestCount << '\n';
+		std::cout << "unfinished " << batch.unfinishedCount << '\n';
+		std::cout << "commands " << batch.executedCount << '\n';
+		std::cout << "seconds " << batch.seconds << '\n';
+		std::cout << "commands-per-second " << static_cast<std::uint64_t>(batch.getCommandsPerSecond()) << '\n';
+
+		return (batch.unfinishedCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	const auto result = runPlaythrough(novel, options);
+
+	std::cout << std::hex << std::setfill('0');
+
+	for(const auto & event : result.events)
+	{
+		switch(event.type)
+		{
+		case PlaythroughEventType::Label:
+			std::cout << "label " << *event.label << '\n';
+			break;
+
+		case PlaythroughEventType::Text:
+			std::cout << "text " << std::setw(16) << event.value << '\n';
+			break;
+
+		case PlaythroughEventType::Choice:
+			std::cout << "choice " << std::dec << event.value << std::hex << '\n';
+			break;
+		}
+	}
+
+	std::cout << "digest " << std::setw(16) << result.digest << '\n';
+	std::cout << std::dec << getStateName(result.finalState) << ' ' << result.executedCount << '\n';
+
+	return (result.finalState == EngineState::Finished) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Tries every choice option and random outcome, then reports
+// which labels and endscripts can be reached and the shortest way there
+int explore(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	ExplorationOptions options;
+	std::vector<std::string> paths;
+
+	// Skip the program path and --explore
+	for(int index = 2; index < argumentCount; ++index)
+	{
+		const std::string argument = arguments[index];
+
+		if((argument.compare(0, 2, "--") == 0) && ((index + 1) >= argumentCount))
+		{
+			printUsage();
+			return EXIT_FAILURE;
+		}
+
+		bool isValid = true;
+
+		if(argument == "--threads")
+			isValid = tryParseSize(arguments[++index], options.threadCount);
+		else if(argument == "--states")
+			isValid = tryParseSize(arguments[++index], options.maximumStates);
+		else
+			paths.push_back(argument);
+
+		if(!isValid)
+		{
+			std::cerr << "Error: invalid value for " << argument << '\n';
+			return EXIT_FAILURE;
+		}
+	}
+
+	if(paths.empty())
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Script> scripts;
+	if(!tryLoadScripts(paths, scripts))
+		return EXIT_FAILURE;
+
+	const Novel novel(std::move(scripts));
+
+	BranchExplorer explorer(novel, options);
+	const auto result = explorer.explore();
+
+	std::size_t unreachableCount = 0;
+
+	for(const auto & target : result.targets)
+	{
+		const Script & script = novel.getScript(target.scriptIndex);
+
+		if(target.type == ReachTargetType::Label)
+			std::cout << "label " << script.getName() << ' ' << cast<LabelCommand>(script.getCommand(target.commandIndex)).getLabel();
+		else
+			std::cout << "endscript " << script.getName() << ' ' << target.commandIndex;
+
+		if(!target.isReachable)
+		{
+			std::cout << ": unreachable\n";
+			++unreachableCount;
+			continue;
+		}
+
+		std::cout << ':';
+
+		if(target.path.empty())
+			std::cout << " start";
+
+		for(std::size_t index = 0; index < target.path.size(); ++index)
+		{
+			const auto & decision = target.path[index];
+			std::cout << ((index > 0) ? ", " : " ") << ((decision.type == DecisionType::Choice) ? "choice " : "random ") << decision.value;
+		}
+
+		std::cout << '\n';
+	}
+
+	std::cout << "states " << result.stateCount << '\n';
+	std::cout << "unreachable " << unreachableCount << '\n';
+	std::cout << "faulted " << result.faultedCount << '\n';
+	std::cout << "unfinished " << result.unfinishedCount << '\n';
+
+	if(!result.isComplete)
+		std::cout << "incomplete, state limit reached\n";
+
+	return EXIT_SUCCESS;
+}
+
+// Lists every asset the scripts use, and with --root,
+// which of them are missing and which files nothing uses
+int manifest(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	std::string rootPath;
+	std::vector<std::string> paths;
+
+	// Skip the program path and --manifest
+	for(int index = 2; index < argumentCount; ++index)
+	{
+		const std::string argument = arguments[index];
+
+		if(argument == "--root")
+		{
+			if((index + 1) >= argumentCount)
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+
+			rootPath = arguments[++index];
+
+			if((rootPath.back() != '/') && (rootPath.back() != '\\'))
+				rootPath += '/';
+		}
+		else
+		{
+			paths.push_back(argument);
+		}
+	}
+
+	if(paths.empty())
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Script> scripts;
+	if(!tryLoadScripts(paths, scripts))
+		return EXIT_FAILURE;
+
+	const AssetManifest assets(scripts);
+
+	for(const auto & entry : assets.getEntries())
+		std::cout << getAssetDirectory(entry.type) << entry.path << ' ' << entry.referenceCount << ' ' << scripts[entry.firstScript].getName() << ':' << entry.firstCommand << '\n';
+
+	if(rootPath.empty())
+		return EXIT_SUCCESS;
+
+	const auto report = assets.checkFiles(rootPath);
+
+	for(const auto index : report.missing)
+	{
+		const auto & entry = assets.getEntries()[index];
+		std::cout << "missing " << getAssetDirectory(entry.type) << entry.path << '\n';
+	}
+
+	for(const auto & file : report.orphaned)
+		std::cout << "orphaned " << file << '\n';
+
+	return report.missing.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Reports how the scripts link to each other through jump,
+// starting from the entry script, main.scr unless given
+int graph(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	std::string entryName = "main.scr";
+	std::vector<std::string> paths;
+
+	// Skip the program path and --graph
+	for(int index = 2; index < argumentCount; ++index)
+	{
+		const std::string argument = arguments[index];
+
+		if(argument == "--entry")
+		{
+			if((index + 1) >= argumentCount)
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+
+			entryName = arguments[++index];
+		}
+		else
+		{
+			paths.push_back(argument);
+		}
+	}
+
+	if(paths.empty())
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Script> scripts;
+	if(!tryLoadScripts(paths, scripts))
+		return EXIT_FAILURE;
+
+	const Novel novel(std::move(scripts));
+
+	std::size_t entryScript;
+	if(!novel.tryGetScriptIndex(entryName, entryScript))
+	{
+		std::cerr << "Error: entry script " << entryName << " not found\n";
+		return EXIT_FAILURE;
+	}
+
+	const ScriptGraph scriptGraph(novel, entryScript);
+
+	for(std::size_t index = 0; index < scriptGraph.size(); ++index)
+	{
+		std::cout << "script " << novel.getScript(index).getName() << " ->";
+
+		for(const auto target : scriptGraph.getSuccessors(index))
+			std::cout << ' ' << novel.getScript(target).getName();
+
+		std::cout << '\n';
+	}
+
+	for(const auto index : scriptGraph.getUnreachable())
+		std::cout << "unreachable " << novel.getScript(index).getName() << '\n';
+
+	// Only components that are actual cycles are worth reporting
+	for(const auto & component : scriptGraph.getComponents())
+	{
+		const bool isCycle = (component.size() > 1) || std::binary_search(scriptGraph.getSuccessors(component[0]).begin(), scriptGraph.getSuccessors(component[0]).end(), component[0]);
+
+		if(!isCycle)
+			continue;
+
+		std::cout << "cycle";
+
+		for(const auto index : component)
+			std::cout << ' ' << novel.getScript(index).getName();
+
+		std::cout << '\n';
+	}
+
+	std::cout << "preload";
+
+	for(const auto index : scriptGraph.getPreloadOrder())
+		std::cout << ' ' << novel.getScript(index).getName();
+
+	std::cout << '\n';
+
+	return EXIT_SUCCESS;
+}
+
+// Writes a text index of every text and choice command in the scripts
+int index(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	// Skip the program path, --index and the index file
+	if(argumentCount < 4)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	const std::string indexPath = arguments[2];
+	const std::vector<std::string> paths(arguments + 3, arguments + argumentCount);
+
+	std::vector<Script> scripts;
+	if(!tryLoadScripts(paths, scripts))
+		return EXIT_FAILURE;
+
+	const TextIndexBuilder builder(scripts);
+
+	if(!builder.tryWrite(indexPath))
+	{
+		std::cerr << "Error: could not write " << indexPath << '\n';
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "indexed " << builder.getEntryCount() << " texts from " << scripts.size() << " scripts\n";
+
+	return EXIT_SUCCESS;
+}
+
+// Prints every text holding the given words, ignoring case, as
+// script:command, where command is the command index of the unoptimised script
+int search(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	if(argumentCount < 4)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	const std::string indexPath = arguments[2];
+
+	// Unquoted words are searched for as one phrase
+	std::string query = arguments[3];
+
+	for(int index = 4; index < argumentCount; ++index)
+	{
+		query += ' ';
+		query += arguments[index];
+	}
+
+	TextIndex textIndex;
+	if(!textIndex.tryOpen(indexPath))
+	{
+		std::cerr << "Error: " << indexPath << " is not a text index\n";
+		return EXIT_FAILURE;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto hits = textIndex.search(query);
+	const auto end = std::chrono::steady_clock::now();
+
+	for(const auto & hit : hits)
+		std::cout << textIndex.getScriptName(hit.scriptIndex) << ':' << hit.commandIndex << ": " << textIndex.getText(hit.entryIndex) << '\n';
+
+	const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+	std::cout << hits.size() << " hits in " << (microseconds / 1000.0) << " ms\n";
+
+	return hits.empty() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Writes a translation catalog beside every script,
+// with the .catalog extension in place of its own
+int extract(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	if(argumentCount < 3)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	// Skip the program path and --extract
+	const std::vector<std::string> paths(arguments + 2, arguments + argumentCount);
+	std::vector<std::string> messages(paths.size());
+	std::atomic<bool> isComplete(true);
+
+	forEachInParallel(paths.size(), 0, [&](std::size_t index)
+	{
+		const std::string & path = paths[index];
+
+		std::string catalogPath;
+		if(!tryReplaceFileExtension(path, catalogPath, ".catalog"))
+			catalogPath = (path + ".catalog");
+
+		std::ifstream source(path, std::ios::binary);
+		std::ofstream catalogFile(catalogPath, std::ios::binary);
+
+		if(!source || !catalogFile)
+		{
+			messages[index] = ("Error: could not open " + (!source ? path : catalogPath));
+			isComplete = false;
+			return;
+		}
+
+		CatalogWriter writer(catalogFile);
+		const std::size_t count = extractCatalog(source, Script::getFileName(path), writer);
+
+		messages[index] = (catalogPath + ": " + std::to_string(count) + " strings");
+	});
+
+	for(const auto & message : messages)
+		std::cout << message << '\n';
+
+	return isComplete ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Writes a copy of every script into the output directory with
+// the strings replaced from the catalog extract wrote beside it
+int inject(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+
+	if(argumentCount < 4)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::string outputDirectory = arguments[2];
+
+	if((outputDirectory.back() != '/') && (outputDirectory.back() != '\\'))
+		outputDirectory += '/';
+
+	// Skip the program path, --inject and the output directory
+	const std::vector<std::string> paths(arguments + 3, arguments + argumentCount);
+	std::vector<std::string> messages(paths.size());
+	std::atomic<bool> isComplete(true);
+
+	forEachInParallel(paths.size(), 0, [&](std::size_t index)
+	{
+		const std::string & path = paths[index];
+		const std::string name = Script::getFileName(path);
+
+		std::string catalogPath;
+		if(!tryReplaceFileExtension(path, catalogPath, ".catalog"))
+			catalogPath = (path + ".catalog");
+
+		// Written beside the output and renamed over it once complete,
+		// so a script can be translated in place
+		const std::string outputPath = (outputDirectory + name);
+		const std::string temporaryPath = (outputPath + ".tmp");
+
+		InjectReport report;
+
+		{
+			std::ifstream source(path, std::ios::binary);
+			std::ifstream catalogFile(catalogPath, std::ios::binary);
+			std::ofstream output(temporaryPath, std::ios::binary);
+
+			if(!source || !catalogFile || !output)
+			{
+				output.close();
+				std::remove(temporaryPath.c_str());
+
+				messages[index] = ("Error: could not open " + (!source ? path : !catalogFile ? catalogPath : temporaryPath));
+				isComplete = false;
+				return;
+			}
+
+			CatalogReader catalog(catalogFile);
+			report = injectCatalog(source, catalog, name, output);
+		}
+
+		// The entries after a malformed one were never read,
+		// so the output is left as it was
+		if(report.malformedLine != 0)
+		{
+			std::remove(temporaryPath.c_str());
+
+			messages[index] = ("Error: " + catalogPath + ':' + std::to_string(report.malformedLine) + ": malformed entry, " + outputPath + " not written");
+			isComplete = false;
+			return;
+		}
+
+		std::remove(outputPath.c_str());
+
+		if(std::rename(temporaryPath.c_str(), outputPath.c_str()) != 0)
+		{
+			messages[index] = ("Error: could not write " + outputPath);
+			isComplete = false;
+			return;
+		}
+
+		messages[index] = (outputPath + ": " + std::to_string(report.translatedCount) + " translated, " + std::to_string(report.staleCount) + " stale, " + std::to_string(report.rejectedCount) + " rejected");
+	});
+
+	for(const auto & message : messages)
+		std::cout << message << '\n';
+
+	return isComplete ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Milliseconds spent in each step of converting a script
+struct PhaseTimes
+{
+	double read = 0;
+	double parse = 0;
+	double filter = 0;
+	double format = 0;
+
+	void add(const PhaseTimes & other)
+	{
+		this->read += other.read;
+		this->parse += other.parse;
+		this->filter += other.filter;
+		this->format += other.format;
+	}
+};
+
+struct FileStatistics
+{
+	VNVita::CommandStatistics commands;
+
+	// Keyed by command kind and message
+	std::map<std::string, std::size_t> parseErrors;
+
+	PhaseTimes times;
+
+	void add(const FileStatistics & other)
+	{
+		this->commands.add(other.commands);
+
+		for(const auto & error : other.parseErrors)
+			this->parseErrors[error.first] += error.second;
+
+		this->times.add(other.times);
+	}
+};
+
+double getMilliseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Runs the same steps as processFile, but reads the whole file
+// before parsing so reading and parsing can be timed apart,
+// and formats into memory so disk writes don't count as formatting
+bool tryCollectStatistics(const std::string & path, FileStatistics & statistics)
+{
+	using namespace VNVita;
+	using Clock = std::chrono::steady_clock;
+
+	const auto start = Clock::now();
+
+	std::ifstream inputFile(path);
+	if(!inputFile)
+		return false;
+
+	std::string text((std::istreambuf_iterator<char>(inputFile)), std::istreambuf_iterator<char>());
+
+	const auto read = Clock::now();
+
+	Parser parser(std::make_shared<StringCharReader>(std::move(text)));
+	const auto results = readResults(parser);
+
+	const auto parsed = Clock::now();
+
+	const auto commands = filterErroneousCommands(results);
+
+	const auto filtered = Clock::now();
+
+	std::ostringstream output;
+	CommandFormatVisitor formatter(output);
+
+	for(const auto & command : commands)
+		formatter.visit(*command);
+
+	formatter.flush();
+
+	const auto formatted = Clock::now();
+
+	statistics.times.read = getMilliseconds(start, read);
+	statistics.times.parse = getMilliseconds(read, parsed);
+	statistics.times.filter = getMilliseconds(parsed, filtered);
+	statistics.times.format = getMilliseconds(filtered, formatted);
+
+	CommandStatisticsVisitor counter;
+
+	for(const auto & command : commands)
+		counter.visit(*command);
+
+	statistics.commands = counter.getStatistics();
+
+	for(const auto & result : results)
+		if(result.hasException())
+			++statistics.parseErrors[std::string(getCommandKindName(result.getCommand()->getKind())) + ": " + result.getException().what()];
+
+	return true;
+}
+
+void writeJsonString(std::ostream & output, const std::string & text)
+{
+	output << '"';
+
+	for(const char c : text)
+	{
+		switch(c)
+		{
+		case '"': output << "\\\""; break;
+		case '\\': output << "\\\\"; break;
+		case '\n': output << "\\n"; break;
+		case '\r': output << "\\r"; break;
+		case '\t': output << "\\t"; break;
+		default:
+			if(static_cast<unsigned char>(c) < 0x20)
+				output << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xF] << "0123456789abcdef"[c & 0xF];
+			else
+				output << c;
+			break;
+		}
+	}
+
+	output << '"';
+}
+
+// Writes the members of a statistics object, indented by indent
+void writeStatisticsJson(std::ostream & output, const FileStatistics & statistics, const std::string & indent)
+{
+	using namespace VNVita;
+
+	output << indent << "\"commandCount\": " << statistics.commands.getCommandCount() << ",\n";
+	output << indent << "\"commands\": {";
+
+	for(std::size_t index = 0; index < commandKindCount; ++index)
+	{
+		const auto kind = static_cast<CommandKind>(index);
+
+		output << ((index > 0) ? ", " : " ");
+		writeJsonString(output, getCommandKindName(kind));
+		output << ": " << statistics.commands.getKindCount(kind);
+	}
+
+	output << " },\n";
+	output << indent << "\"textCharacters\": " << statistics.commands.textCharacterCount << ",\n";
+	output << indent << "\"textWords\": " << statistics.commands.textWordCount << ",\n";
+	output << indent << "\"maximumIfDepth\": " << statistics.commands.maximumIfDepth << ",\n";
+	output << indent << "\"parseErrors\": {";
+
+	bool isFirst = true;
+
+	for(const auto & error : statistics.parseErrors)
+	{
+		output << (isFirst ? " " : ", ");
+		writeJsonString(output, error.first);
+		output << ": " << error.second;
+		isFirst = false;
+	}
+
+	output << (isFirst ? "},\n" : " },\n");
+	output << indent << "\"milliseconds\": { \"read\": " << statistics.times.read << ", \"parse\": " << statistics.times.parse << ", \"filter\": " << statistics.times.filter << ", \"format\": " << statistics.times.format << " }\n";
+}
+
+// Reports command counts, text sizes, parse errors and the time
+// spent in each conversion step, per file and in total, as JSON.
+// Files are timed one at a time so they don't compete for the disk.
+int stats(int argumentCount, const char * arguments[])
+{
+	if(argumentCount < 3)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	FileStatistics total;
+	bool isComplete = true;
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "{\n\t\"files\": [";
+
+	bool isFirst = true;
+
+	// Skip the program path and --stats
+	for(int index = 2; index < argumentCount; ++index)
+	{
+		const std::string path = arguments[index];
+
+		FileStatistics statistics;
+		if(!tryCollectStatistics(path, statistics))
+		{
+			std::cerr << "Error: could not open " << path << '\n';
+			isComplete = false;
+			continue;
+		}
+
+		total.add(statistics);
+
+		std::cout << (isFirst ? "\n" : ",\n") << "\t\t{\n\t\t\t\"path\": ";
+		writeJsonString(std::cout, path);
+		std::cout << ",\n";
+		writeStatisticsJson(std::cout, statistics, "\t\t\t");
+		std::cout << "\t\t}";
+
+		isFirst = false;
+	}
+
+	std::cout << (isFirst ? "],\n" : "\n\t],\n") << "\t\"total\": {\n";
+	writeStatisticsJson(std::cout, total, "\t\t");
+	std::cout << "\t}\n}\n";
+
+	return isComplete ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Times reading every path and writing it back out with each backend,
+// after dropping the files from the page cache so reads come from disk.
+// The copies are written beside the originals and removed again.
+int ioBenchmark(int argumentCount, const char * arguments[])
+{
+	using namespace VNVita;
+	using Clock = std::chrono::steady_clock;
+
+	std::size_t roundCount = 3;
+	std::vector<std::string> paths;
+
+	// Skip the program path and --io-benchmark
+	for(int index = 2; index < argumentCount; ++index)
+	{
+		const std::string argument = arguments[index];
+
+		if(argument == "--rounds")
+		{
+			if(((index + 1) >= argumentCount) || !tryParseSize(arguments[index + 1], roundCount) || (roundCount == 0))
+			{
+				printUsage();
+				return EXIT_FAILURE;
+			}
+
+			++index;
+		}
+		else
+		{
+			paths.push_back(argument);
+		}
+	}
+
+	if(paths.empty())
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+
+	bool isComplete = true;
+
+	for(const FileIOBackend backend : { FileIOBackend::Stream, FileIOBackend::IoUring })
+	{
+		const auto fileIO = makeFileIO(backend);
+
+		if((backend == FileIOBackend::IoUring) && (std::string(fileIO->getName()) != "io_uring"))
+		{
+			std::cout << "io_uring: not available\n";
+			continue;
+		}
+
+		double bestReadTime = 0;
+		double bestWriteTime = 0;
+		std::size_t byteCount = 0;
+		std::size_t failureCount = 0;
+		bool isCold = true;
+
+		for(std::size_t round = 0; round < roundCount; ++round)
+		{
+			for(const auto & path : paths)
+				isCold = tryEvictFromPageCache(path) && isCold;
+
+			ReadQueue queue;
+
+			const auto readStart = Clock::now();
+			fileIO->readFiles(paths, queue);
+			const auto readEnd = Clock::now();
+
+			queue.close();
+
+			std::vector<FileWrite> writes;
+			byteCount = 0;
+			failureCount = 0;
+
+			FileRead read;
+			while(queue.tryPop(read))
+			{
+				if(!read.isRead)
+				{
+					++failureCount;
+					continue;
+				}
+
+				byteCount += read.content.size();
+				writes.push_back(FileWrite { (paths[read.index] + ".iobench"), std::move(read.content), true, false });
+			}
+
+			const auto writeStart = Clock::now();
+			fileIO->writeFiles(writes);
+			const auto writeEnd = Clock::now();
+
+			for(const auto & write : writes)
+			{
+				if(!write.isWritten)
+					++failureCount;
+
+				std::remove(write.path.c_str());
+			}
+
+			const double readTime = getMilliseconds(readStart, readEnd);
+			const double writeTime = getMilliseconds(writeStart, writeEnd);
+
+			if((round == 0) || (readTime < bestReadTime))
+				bestReadTime = readTime;
+
+			if((round == 0) || (writeTime < bestWriteTime))
+				bestWriteTime = writeTime;
+		}
+
+		std::cout << fileIO->getName() << ": " << paths.size() << " files, " << byteCount << " bytes, ";
+		std::cout << "read in " << bestReadTime << " ms (" << (isCold ? "cold" : "warm") << " cache), written in " << bestWriteTime << " ms\n";
+
+		if(failureCount > 0)
+		{
+			std::cerr << "Error: " << fileIO->getName() << " failed on " << failureCount << " files\n";
+			isComplete = false;
+		}
+	}
+
+	return isComplete ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
@@ -0,0 +1 @@
+#include "Analysis\Analysis.h"
\ No newline at end of file
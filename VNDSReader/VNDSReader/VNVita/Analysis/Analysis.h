@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../Commands.h"
+
+#include "IfBlockTable.h"
+#include "LabelIndex.h"
+#include "ControlFlowGraph.h"
+#include "JumpTable.h"
+#include "VariableResolution.h"
+#include "Asset.h"
+#include "PrefetchPlan.h"
+#include "AssetManifest.h"
+#include "ScriptGraph.h"
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstdint>
+#include <string>
+
+#include "../Commands.h"
+
+namespace VNVita
+{
+	enum class AssetType : std::uint8_t
+	{
+		// bgload
+		Background,
+
+		// setimg
+		Foreground,
+
+		// sound
+		Sound,
+
+		// music
+		Music,
+	};
+
+	struct Asset
+	{
+		AssetType type;
+		std::string path;
+	};
+
+	// Returns false for commands that don't load a file
+	inline bool tryGetAsset(const Command & command, AssetType & type, const std::string * & path)
+	{
+		switch(command.getKind())
+		{
+		case CommandKind::BackgroundLoad:
+			type = AssetType::Background;
+			path = &cast<BackgroundLoadCommand>(command).getPath();
+			return true;
+
+		case CommandKind::SetImage:
+			type = AssetType::Foreground;
+			path = &cast<SetImageCommand>(command).getPath();
+			return true;
+
+		case CommandKind::PlaySound:
+			type = AssetType::Sound;
+			path = &cast<PlaySoundCommand>(command).getPath();
+			return true;
+
+		case CommandKind::PlayMusic:
+			type = AssetType::Music;
+			path = &cast<PlayMusicCommand>(command).getPath();
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	// The directory of a VNDS novel that holds assets of the type
+	inline const char * getAssetDirectory(AssetType type)
+	{
+		switch(type)
+		{
+		case AssetType::Background:
+			return "background/";
+		case AssetType::Foreground:
+			return "foreground/";
+		case AssetType::Sound:
+		case AssetType::Music:
+			return "sound/";
+		default:
+			return "";
+		}
+	}
+}
\ No newline at end of file
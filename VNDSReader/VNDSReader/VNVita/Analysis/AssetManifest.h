@@ -0,0 +1,220 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Script.h"
+#include "Asset.h"
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace VNVita
+{
+	struct AssetManifestEntry
+	{
+		AssetType type;
+		std::string path;
+		std::size_t referenceCount;
+
+		// Where the first command in script order uses it
+		std::size_t firstScript;
+		std::size_t firstCommand;
+	};
+
+	struct AssetFileReport
+	{
+		// Indices into AssetManifest::getEntries
+		std::vector<std::size_t> missing;
+
+		// Paths relative to the novel directory
+		std::vector<std::string> orphaned;
+	};
+
+	// Every asset a set of scripts refers to, each listed once
+	// in order of first use, with how often it's referred to
+	class AssetManifest
+	{
+	private:
+		std::vector<AssetManifestEntry> entries;
+		std::unordered_map<std::string, std::size_t> indices;
+
+	public:
+		AssetManifest() = default;
+
+		AssetManifest(const std::vector<Script> & scripts)
+		{
+			for(std::size_t scriptIndex = 0; scriptIndex < scripts.size(); ++scriptIndex)
+				this->addScript(scripts[scriptIndex], scriptIndex);
+		}
+
+		const std::vector<AssetManifestEntry> & getEntries() const
+		{
+			return this->entries;
+		}
+
+		std::size_t size() const
+		{
+			return this->entries.size();
+		}
+
+		// Lists the asset directories once each instead of
+		// stat-ing every entry, then compares the two sets.
+		// rootPath is the novel's directory, with a trailing separator.
+		AssetFileReport checkFiles(const std::string & rootPath) const
+		{
+			std::unordered_set<std::string> files;
+
+			const AssetType types[] = { AssetType::Background, AssetType::Foreground, AssetType::Sound };
+
+			for(const AssetType type : types)
+			{
+				const std::string directory = getAssetDirectory(type);
+				listFiles(rootPath + directory, directory, files);
+			}
+
+			AssetFileReport report;
+			std::unordered_set<std::string> referenced;
+
+			for(std::size_t index = 0; index < this->entries.size(); ++index)
+			{
+				const auto & entry = this->entries[index];
+				const std::string file = (getAssetDirectory(entry.type) + entry.path);
+
+				if(files.count(file) == 0)
+					report.missing.push_back(index);
+
+				referenced.insert(file);
+			}
+
+			for(const auto & file : files)
+				if(referenced.count(file) == 0)
+					report.orphaned.push_back(file);
+
+			std::sort(report.orphaned.begin(), report.orphaned.end());
+			return report;
+		}
+
+	private:
+		void addScript(const Script & script, std::size_t scriptIndex)
+		{
+			for(std::size_t index = 0; index < script.size(); ++index)
+			{
+				AssetType type;
+				const std::string * path;
+				if(!tryGetAsset(script.getCommand(index), type, path) || isPlaceholder(*path))
+					continue;
+
+				const auto result = this->indices.emplace(static_cast<char>(type) + *path, this->entries.size());
+
+				if(result.second)
+					this->entries.push_back(AssetManifestEntry { type, *path, 1, scriptIndex, index });
+				else
+					++this->entries[result.first->second].referenceCount;
+			}
+		}
+
+		// "~" clears instead of loading
+		static bool isPlaceholder(const std::string & path)
+		{
+			return (path.empty() || (path == "~"));
+		}
+
+		// Adds prefix + the relative path of every file below directory
+		static void listFiles(const std::string & directory, const std::string & prefix, std::unordered_set<std::string> & files)
+		{
+#if defined(_WIN32)
+			WIN32_FIND_DATAA data;
+			HANDLE handle = FindFirstFileA((directory + '*').c_str(), &data);
+
+			if(handle == INVALID_HANDLE_VALUE)
+				return;
+
+			do
+			{
+				const std::string name = data.cFileName;
+
+				if((name == ".") || (name == ".."))
+					continue;
+
+				if((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+					listFiles(directory + name + '/', prefix + name + '/', files);
+				else
+					files.insert(prefix + name);
+			}
+			while(FindNextFileA(handle, &data) != 0);
+
+			FindClose(handle);
+#else
+			DIR * handle = opendir(directory.c_str());
+
+			if(handle == nullptr)
+				return;
+
+			while(const dirent * entry = readdir(handle))
+			{
+				const std::string name = entry->d_name;
+
+				if((name == ".") || (name == ".."))
+					continue;
+
+				// d_type saves a stat per file where the file system fills it in
+				if(entry->d_type == DT_DIR)
+				{
+					listFiles(directory + name + '/', prefix + name + '/', files);
+				}
+				else if(entry->d_type == DT_UNKNOWN)
+				{
+					DIR * child = opendir((directory + name).c_str());
+
+					if(child == nullptr)
+					{
+						files.insert(prefix + name);
+					}
+					else
+					{
+						closedir(child);
+						listFiles(directory + name + '/', prefix + name + '/', files);
+					}
+				}
+				else
+				{
+					files.insert(prefix + name);
+				}
+			}
+
+			closedir(handle);
+#endif
+		}
+	};
+}
\ No newline at end of file
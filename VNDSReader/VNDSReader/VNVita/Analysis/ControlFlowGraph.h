@@ -0,0 +1,240 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../Commands.h"
+#include "IfBlockTable.h"
+#include "LabelIndex.h"
+
+namespace VNVita
+{
+	// How control leaves a basic block
+	enum class BlockExit : std::uint8_t
+	{
+		// Runs on into the next block, which starts with a label or follows a fi
+		FallThrough,
+
+		// An if, into its body or past its fi
+		Branch,
+
+		GoTo,
+
+		// A choice, which waits for the player then runs on
+		Choice,
+
+		// Leaves the script, the target is in the novel's JumpTable
+		Jump,
+
+		EndScript,
+
+		// Runs off the end of the script
+		End,
+	};
+
+	struct BasicBlock
+	{
+		// Commands [first, last)
+		std::size_t first;
+		std::size_t last;
+
+		BlockExit exit;
+
+		// Blocks of the same script, in order: the next block,
+		// then for a branch the block past the fi
+		std::vector<std::size_t> successors;
+		std::vector<std::size_t> predecessors;
+
+		// From the start of the script. Blocks only entered by
+		// a jump from another script count as unreachable.
+		bool isReachable;
+	};
+
+	// A script split into basic blocks: runs of commands that are always
+	// executed from first to last. Blocks start at index 0, at every label
+	// and after every if, fi, goto, choice, jump and endscript.
+	//
+	// A goto to a missing label and an if without a fi leave their block
+	// without a successor in the script.
+	class ControlFlowGraph
+	{
+	private:
+		std::vector<BasicBlock> blocks;
+		std::vector<std::uint32_t> blockIndices;
+
+	public:
+		ControlFlowGraph() = default;
+
+		ControlFlowGraph(const std::vector<std::shared_ptr<Command>> & commands, const IfBlockTable & ifBlocks, const LabelIndex & labels)
+		{
+			this->findBlocks(commands);
+			this->linkBlocks(commands, ifBlocks, labels);
+			this->markReachable();
+		}
+
+		std::size_t size() const
+		{
+			return this->blocks.size();
+		}
+
+		const std::vector<BasicBlock> & getBlocks() const
+		{
+			return this->blocks;
+		}
+
+		const BasicBlock & getBlock(std::size_t index) const
+		{
+			return this->blocks[index];
+		}
+
+		// The block holding a command
+		std::size_t getBlockIndex(std::size_t commandIndex) const
+		{
+			return this->blockIndices[commandIndex];
+		}
+
+		bool isReachable(std::size_t commandIndex) const
+		{
+			return this->blocks[this->blockIndices[commandIndex]].isReachable;
+		}
+
+	private:
+		static bool endsBlock(CommandKind kind)
+		{
+			switch(kind)
+			{
+			case CommandKind::If:
+			case CommandKind::Fi:
+			case CommandKind::GoTo:
+			case CommandKind::Choice:
+			case CommandKind::Jump:
+			case CommandKind::EndScript:
+				return true;
+
+			default:
+				return false;
+			}
+		}
+
+		void findBlocks(const std::vector<std::shared_ptr<Command>> & commands)
+		{
+			this->blockIndices.resize(commands.size());
+
+			for(std::size_t index = 0; index < commands.size(); ++index)
+			{
+				const CommandKind kind = commands[index]->getKind();
+
+				const bool isLeader = (index == 0) || (kind == CommandKind::Label) || endsBlock(commands[index - 1]->getKind());
+
+				if(isLeader)
+				{
+					if(!this->blocks.empty())
+						this->blocks.back().last = index;
+
+					this->blocks.push_back(BasicBlock { index, index, BlockExit::FallThrough, {}, {}, false });
+				}
+
+				this->blockIndices[index] = static_cast<std::uint32_t>(this->blocks.size() - 1);
+			}
+
+			if(!this->blocks.empty())
+				this->blocks.back().last = commands.size();
+		}
+
+		void linkBlocks(const std::vector<std::shared_ptr<Command>> & commands, const IfBlockTable & ifBlocks, const LabelIndex & labels)
+		{
+			for(std::size_t blockIndex = 0; blockIndex < this->blocks.size(); ++blockIndex)
+			{
+				BasicBlock & block = this->blocks[blockIndex];
+				const std::size_t lastIndex = (block.last - 1);
+				const Command & command = *commands[lastIndex];
+				const bool hasNext = (block.last < commands.size());
+
+				switch(command.getKind())
+				{
+				case CommandKind::If:
+					{
+						block.exit = BlockExit::Branch;
+
+						if(hasNext)
+							block.successors.push_back(blockIndex + 1);
+
+						std::size_t fiIndex;
+						if(ifBlocks.tryGetMatchingFi(lastIndex, fiIndex) && ((fiIndex + 1) < commands.size()))
+							block.successors.push_back(this->blockIndices[fiIndex + 1]);
+					}
+					break;
+
+				case CommandKind::GoTo:
+					{
+						block.exit = BlockExit::GoTo;
+
+						std::size_t labelIndex;
+						if(labels.tryGetIndex(cast<GoToCommand>(command).getLabel(), labelIndex))
+							block.successors.push_back(this->blockIndices[labelIndex]);
+					}
+					break;
+
+				case CommandKind::Jump:
+					block.exit = BlockExit::Jump;
+					break;
+
+				case CommandKind::EndScript:
+					block.exit = BlockExit::EndScript;
+					break;
+
+				default:
+					block.exit = !hasNext ? BlockExit::End : (command.getKind() == CommandKind::Choice) ? BlockExit::Choice : BlockExit::FallThrough;
+
+					if(hasNext)
+						block.successors.push_back(blockIndex + 1);
+					break;
+				}
+
+				for(const std::size_t successor : block.successors)
+					this->blocks[successor].predecessors.push_back(blockIndex);
+			}
+		}
+
+		void markReachable()
+		{
+			if(this->blocks.empty())
+				return;
+
+			std::vector<std::size_t> pending;
+			pending.push_back(0);
+			this->blocks[0].isReachable = true;
+
+			while(!pending.empty())
+			{
+				const std::size_t blockIndex = pending.back();
+				pending.pop_back();
+
+				for(const std::size_t successor : this->blocks[blockIndex].successors)
+					if(!this->blocks[successor].isReachable)
+					{
+						this->blocks[successor].isReachable = true;
+						pending.push_back(successor);
+					}
+			}
+		}
+	};
+}
\ No newline at end of file
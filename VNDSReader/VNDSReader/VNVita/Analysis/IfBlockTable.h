@@ -0,0 +1,138 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../Commands.h"
+#include "../ParseResult.h"
+
+namespace VNVita
+{
+	// Maps every if to its matching fi and every fi back to its if,
+	// so a block can be skipped without walking it.
+	class IfBlockTable
+	{
+	public:
+		static constexpr std::size_t noMatch = static_cast<std::size_t>(-1);
+
+	private:
+		std::vector<std::size_t> matches;
+		std::size_t maximumDepth = 0;
+
+	public:
+		IfBlockTable() = default;
+
+		IfBlockTable(const std::vector<std::shared_ptr<Command>> & commands)
+		{
+			this->build(commands.size(), [&commands](std::size_t index)
+			{
+				return commands[index].get();
+			});
+		}
+
+		IfBlockTable(const std::vector<ParseResult> & results)
+		{
+			this->build(results.size(), [&results](std::size_t index)
+			{
+				return results[index].getCommand().get();
+			});
+		}
+
+		std::size_t size() const
+		{
+			return this->matches.size();
+		}
+
+		std::size_t getMaximumDepth() const
+		{
+			return this->maximumDepth;
+		}
+
+		// Returns noMatch for unbalanced ifs and fis and for other commands
+		std::size_t getMatchingIndex(std::size_t index) const
+		{
+			return this->matches[index];
+		}
+
+		bool tryGetMatchingFi(std::size_t ifIndex, std::size_t & fiIndex) const
+		{
+			const std::size_t match = this->matches[ifIndex];
+
+			if((match == noMatch) || (match < ifIndex))
+				return false;
+
+			fiIndex = match;
+			return true;
+		}
+
+		bool tryGetMatchingIf(std::size_t fiIndex, std::size_t & ifIndex) const
+		{
+			const std::size_t match = this->matches[fiIndex];
+
+			if((match == noMatch) || (match > fiIndex))
+				return false;
+
+			ifIndex = match;
+			return true;
+		}
+
+	private:
+		template< typename CommandAccessor >
+		void build(std::size_t count, CommandAccessor getCommand)
+		{
+			const std::size_t unmatched = noMatch;
+			this->matches.assign(count, unmatched);
+
+			std::vector<std::size_t> openIfs;
+
+			for(std::size_t index = 0; index < count; ++index)
+			{
+				const Command * command = getCommand(index);
+
+				if(command == nullptr)
+					continue;
+
+				switch(command->getKind())
+				{
+				case CommandKind::If:
+					openIfs.push_back(index);
+
+					if(openIfs.size() > this->maximumDepth)
+						this->maximumDepth = openIfs.size();
+					break;
+
+				case CommandKind::Fi:
+					if(!openIfs.empty())
+					{
+						const std::size_t ifIndex = openIfs.back();
+						openIfs.pop_back();
+
+						this->matches[ifIndex] = index;
+						this->matches[index] = ifIndex;
+					}
+					break;
+
+				default:
+					break;
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Script.h"
+
+namespace VNVita
+{
+	enum class JumpTargetState : std::uint8_t
+	{
+		Resolved,
+		MissingScript,
+		MissingLabel,
+	};
+
+	struct JumpTarget
+	{
+		std::size_t sourceScript;
+		std::size_t sourceIndex;
+		std::size_t targetScript;
+		std::size_t targetIndex;
+		JumpTargetState state;
+
+		bool isResolved() const
+		{
+			return (this->state == JumpTargetState::Resolved);
+		}
+	};
+
+	// Resolves every jump command in a set of scripts to a (script, index) pair.
+	// A jump without a label targets the start of its script.
+	class JumpTable
+	{
+	private:
+		std::unordered_map<std::string, std::size_t> scriptIndices;
+		std::vector<JumpTarget> targets;
+		std::unordered_map<std::uint64_t, std::size_t> targetIndices;
+		std::size_t unresolvedCount = 0;
+
+	public:
+		JumpTable() = default;
+
+		JumpTable(const std::vector<Script> & scripts)
+		{
+			for(std::size_t index = 0; index < scripts.size(); ++index)
+				this->scriptIndices.emplace(scripts[index].getName(), index);
+
+			for(std::size_t scriptIndex = 0; scriptIndex < scripts.size(); ++scriptIndex)
+			{
+				const auto & script = scripts[scriptIndex];
+
+				for(std::size_t index = 0; index < script.size(); ++index)
+				{
+					const auto jumpCommand = tryCast<JumpCommand>(&script.getCommand(index));
+
+					if(jumpCommand != nullptr)
+						this->addTarget(scripts, scriptIndex, index, *jumpCommand);
+				}
+			}
+		}
+
+		bool tryGetScriptIndex(const std::string & path, std::size_t & scriptIndex) const
+		{
+			auto iterator = this->scriptIndices.find(path);
+
+			if(iterator == this->scriptIndices.end())
+				iterator = this->scriptIndices.find(Script::getFileName(path));
+
+			if(iterator == this->scriptIndices.end())
+				return false;
+
+			scriptIndex = iterator->second;
+			return true;
+		}
+
+		// Returns nullptr if the command at the given location is not a jump
+		const JumpTarget * tryGetTarget(std::size_t scriptIndex, std::size_t commandIndex) const
+		{
+			const auto iterator = this->targetIndices.find(makeKey(scriptIndex, commandIndex));
+
+			if(iterator == this->targetIndices.end())
+				return nullptr;
+
+			return &this->targets[iterator->second];
+		}
+
+		const std::vector<JumpTarget> & getTargets() const
+		{
+			return this->targets;
+		}
+
+		std::size_t getUnresolvedCount() const
+		{
+			return this->unresolvedCount;
+		}
+
+	private:
+		static std::uint64_t makeKey(std::size_t scriptIndex, std::size_t commandIndex)
+		{
+			return ((static_cast<std::uint64_t>(scriptIndex) << 32) | static_cast<std::uint32_t>(commandIndex));
+		}
+
+		void addTarget(const std::vector<Script> & scripts, std::size_t scriptIndex, std::size_t index, const JumpCommand & jumpCommand)
+		{
+			JumpTarget target { scriptIndex, index, 0, 0, JumpTargetState::Resolved };
+
+			if(!this->tryGetScriptIndex(jumpCommand.getPath(), target.targetScript))
+			{
+				target.state = JumpTargetState::MissingScript;
+			}
+			else if(jumpCommand.getLabel().size() > 0)
+			{
+				const auto & labels = scripts[target.targetScript].getLabels();
+
+				if(!labels.tryGetIndex(jumpCommand.getLabel(), target.targetIndex))
+					target.state = JumpTargetState::MissingLabel;
+			}
+
+			if(!target.isResolved())
+				++this->unresolvedCount;
+
+			this->targetIndices.emplace(makeKey(scriptIndex, index), this->targets.size());
+			this->targets.push_back(target);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Commands.h"
+
+namespace VNVita
+{
+	// Maps each label name in a script to the index of its LabelCommand.
+	// Like VNDS, the first label with a given name wins.
+	class LabelIndex
+	{
+	private:
+		std::unordered_map<std::string, std::size_t> indices;
+
+	public:
+		LabelIndex() = default;
+
+		LabelIndex(const std::vector<std::shared_ptr<Command>> & commands)
+		{
+			for(std::size_t index = 0; index < commands.size(); ++index)
+				this->addCommand(*commands[index], index);
+		}
+
+		void addCommand(const Command & command, std::size_t index)
+		{
+			const auto labelCommand = tryCast<LabelCommand>(&command);
+
+			if(labelCommand != nullptr)
+				this->indices.emplace(labelCommand->getLabel(), index);
+		}
+
+		std::size_t size() const
+		{
+			return this->indices.size();
+		}
+
+		bool contains(const std::string & label) const
+		{
+			return (this->indices.find(label) != this->indices.end());
+		}
+
+		bool tryGetIndex(const std::string & label, std::size_t & index) const
+		{
+			const auto iterator = this->indices.find(label);
+
+			if(iterator == this->indices.end())
+				return false;
+
+			index = iterator->second;
+			return true;
+		}
+
+		const std::unordered_map<std::string, std::size_t> & getIndices() const
+		{
+			return this->indices;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,281 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Novel.h"
+#include "Asset.h"
+
+namespace VNVita
+{
+	// The assets wanted from one position, as ids into PrefetchPlan::getAsset
+	class AssetRange
+	{
+	private:
+		const std::uint32_t * first = nullptr;
+		const std::uint32_t * last = nullptr;
+
+	public:
+		AssetRange() = default;
+
+		AssetRange(const std::uint32_t * first, const std::uint32_t * last) :
+			first(first), last(last)
+		{
+		}
+
+		const std::uint32_t * begin() const
+		{
+			return this->first;
+		}
+
+		const std::uint32_t * end() const
+		{
+			return this->last;
+		}
+
+		std::size_t size() const
+		{
+			return static_cast<std::size_t>(this->last - this->first);
+		}
+
+		bool empty() const
+		{
+			return (this->first == this->last);
+		}
+	};
+
+	// For every command of a novel, the assets used by any command
+	// that can run within the next lookahead commands.
+	//
+	// Every path through the scripts' flow graphs is followed, along with
+	// resolved jump targets. Assets are listed nearest first, so a loader
+	// that can't keep up should start from the front.
+	class PrefetchPlan
+	{
+	public:
+		static constexpr std::size_t defaultLookahead = 32;
+		static constexpr std::uint32_t noAsset = static_cast<std::uint32_t>(-1);
+
+	private:
+		static constexpr std::size_t noSuccessor = static_cast<std::size_t>(-1);
+
+	private:
+		std::vector<Asset> assets;
+		std::unordered_map<std::string, std::uint32_t> assetIds;
+
+		// Position of each script's first command in the flat arrays
+		std::vector<std::size_t> scriptOffsets;
+
+		// Asset used by each command or noAsset,
+		// then the prefetch list of every command
+		std::vector<std::uint32_t> commandAssets;
+		std::vector<std::size_t> listOffsets;
+		std::vector<std::uint32_t> lists;
+
+		std::size_t lookahead = defaultLookahead;
+
+	public:
+		PrefetchPlan() = default;
+
+		PrefetchPlan(const Novel & novel, std::size_t lookahead = defaultLookahead) :
+			lookahead(lookahead)
+		{
+			std::size_t commandCount = 0;
+
+			this->scriptOffsets.reserve(novel.size());
+
+			for(const auto & script : novel.getScripts())
+			{
+				this->scriptOffsets.push_back(commandCount);
+				commandCount += script.size();
+			}
+
+			std::vector<std::pair<std::size_t, std::size_t>> successors;
+			successors.reserve(commandCount);
+
+			this->commandAssets.reserve(commandCount);
+
+			for(std::size_t scriptIndex = 0; scriptIndex < novel.size(); ++scriptIndex)
+			{
+				const Script & script = novel.getScript(scriptIndex);
+
+				for(std::size_t index = 0; index < script.size(); ++index)
+				{
+					this->commandAssets.push_back(this->getOrAddAsset(script.getCommand(index)));
+					successors.push_back(this->getSuccessors(novel, scriptIndex, index));
+				}
+			}
+
+			this->buildLists(successors);
+		}
+
+		std::size_t getLookahead() const
+		{
+			return this->lookahead;
+		}
+
+		std::size_t getAssetCount() const
+		{
+			return this->assets.size();
+		}
+
+		const Asset & getAsset(std::uint32_t id) const
+		{
+			return this->assets[id];
+		}
+
+		// The asset the command itself uses, or noAsset
+		std::uint32_t getCommandAsset(std::size_t scriptIndex, std::size_t commandIndex) const
+		{
+			return this->commandAssets[this->scriptOffsets[scriptIndex] + commandIndex];
+		}
+
+		// Pass the engine's script index and program counter
+		// to get what to load before it runs on
+		AssetRange getPrefetchSet(std::size_t scriptIndex, std::size_t programCounter) const
+		{
+			const std::size_t position = (this->scriptOffsets[scriptIndex] + programCounter);
+
+			// A finished script has nothing ahead of it
+			if((position >= this->commandAssets.size()) || (programCounter >= this->getScriptSize(scriptIndex)))
+				return AssetRange();
+
+			return AssetRange(this->lists.data() + this->listOffsets[position], this->lists.data() + this->listOffsets[position + 1]);
+		}
+
+	private:
+		std::size_t getScriptSize(std::size_t scriptIndex) const
+		{
+			const std::size_t end = ((scriptIndex + 1) < this->scriptOffsets.size()) ? this->scriptOffsets[scriptIndex + 1] : this->commandAssets.size();
+			return (end - this->scriptOffsets[scriptIndex]);
+		}
+
+		std::uint32_t getOrAddAsset(const Command & command)
+		{
+			AssetType type;
+			const std::string * path;
+			if(!tryGetAsset(command, type, path))
+				return noAsset;
+
+			return this->getOrAddAsset(type, *path);
+		}
+
+		std::uint32_t getOrAddAsset(AssetType type, const std::string & path)
+		{
+			// Each type is looked up in its own directory
+			const auto result = this->assetIds.emplace(static_cast<char>(type) + path, static_cast<std::uint32_t>(this->assets.size()));
+
+			if(result.second)
+				this->assets.push_back(Asset { type, path });
+
+			return result.first->second;
+		}
+
+		// Flat positions of the commands that can run next, noSuccessor if none
+		std::pair<std::size_t, std::size_t> getSuccessors(const Novel & novel, std::size_t scriptIndex, std::size_t index) const
+		{
+			const Script & script = novel.getScript(scriptIndex);
+			const ControlFlowGraph & flowGraph = script.getFlowGraph();
+			const BasicBlock & block = flowGraph.getBlock(flowGraph.getBlockIndex(index));
+			const std::size_t offset = this->scriptOffsets[scriptIndex];
+
+			if((index + 1) < block.last)
+				return makeSuccessors(offset + index + 1);
+
+			if(block.exit == BlockExit::Jump)
+			{
+				const JumpTarget * target = novel.getJumps().tryGetTarget(scriptIndex, index);
+				if((target == nullptr) || !target->isResolved() || (target->targetIndex >= novel.getScript(target->targetScript).size()))
+					return makeSuccessors(noSuccessor);
+
+				return makeSuccessors(this->scriptOffsets[target->targetScript] + target->targetIndex);
+			}
+
+			const auto & successors = block.successors;
+			const std::size_t first = (successors.size() > 0) ? (offset + flowGraph.getBlock(successors[0]).first) : noSuccessor;
+			const std::size_t second = (successors.size() > 1) ? (offset + flowGraph.getBlock(successors[1]).first) : noSuccessor;
+
+			return makeSuccessors(first, second);
+		}
+
+		static std::pair<std::size_t, std::size_t> makeSuccessors(std::size_t first, std::size_t second = noSuccessor)
+		{
+			return std::make_pair(first, second);
+		}
+
+		// Breadth first from every command, so each list is in order of distance
+		void buildLists(const std::vector<std::pair<std::size_t, std::size_t>> & successors)
+		{
+			const std::size_t commandCount = successors.size();
+
+			// Stamped with the start position instead of cleared for every search
+			const std::size_t unstamped = noSuccessor;
+			std::vector<std::size_t> visited(commandCount, unstamped);
+			std::vector<std::size_t> listed(this->assets.size(), unstamped);
+
+			std::vector<std::size_t> frontier;
+			std::vector<std::size_t> nextFrontier;
+
+			this->listOffsets.reserve(commandCount + 1);
+
+			for(std::size_t start = 0; start < commandCount; ++start)
+			{
+				this->listOffsets.push_back(this->lists.size());
+
+				frontier.clear();
+				frontier.push_back(start);
+				visited[start] = start;
+
+				for(std::size_t depth = 0; (depth < this->lookahead) && !frontier.empty(); ++depth)
+				{
+					nextFrontier.clear();
+
+					for(const std::size_t position : frontier)
+					{
+						const std::uint32_t asset = this->commandAssets[position];
+
+						if((asset != noAsset) && (listed[asset] != start))
+						{
+							listed[asset] = start;
+							this->lists.push_back(asset);
+						}
+
+						const auto & next = successors[position];
+
+						for(const std::size_t successor : { next.first, next.second })
+							if((successor != noSuccessor) && (visited[successor] != start))
+							{
+								visited[successor] = start;
+								nextFrontier.push_back(successor);
+							}
+					}
+
+					frontier.swap(nextFrontier);
+				}
+			}
+
+			this->listOffsets.push_back(this->lists.size());
+		}
+	};
+}
\ No newline at end of file
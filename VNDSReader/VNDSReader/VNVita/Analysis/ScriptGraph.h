@@ -0,0 +1,236 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "../Novel.h"
+#include "JumpTable.h"
+
+namespace VNVita
+{
+	// The scripts of a novel linked by their resolved jumps.
+	//
+	// From an entry script it works out which scripts can be reached,
+	// the strongly connected components (groups of scripts that can
+	// all jump back to each other) and a preload order that lists
+	// scripts nearest the entry first.
+	class ScriptGraph
+	{
+	private:
+		static constexpr std::size_t unvisited = static_cast<std::size_t>(-1);
+
+	private:
+		std::size_t entryScript = 0;
+
+		// Sorted and free of duplicates
+		std::vector<std::vector<std::size_t>> successors;
+
+		std::vector<bool> reachable;
+		std::vector<std::size_t> preloadOrder;
+		std::vector<std::size_t> components;
+		std::size_t componentCount = 0;
+
+	public:
+		ScriptGraph() = default;
+
+		ScriptGraph(const Novel & novel, std::size_t entryScript = 0) :
+			entryScript(entryScript), successors(novel.size())
+		{
+			for(const auto & target : novel.getJumps().getTargets())
+				if(target.isResolved())
+					this->successors[target.sourceScript].push_back(target.targetScript);
+
+			for(auto & targets : this->successors)
+			{
+				std::sort(targets.begin(), targets.end());
+				targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+			}
+
+			this->findReachable();
+			this->findComponents();
+		}
+
+		std::size_t size() const
+		{
+			return this->successors.size();
+		}
+
+		std::size_t getEntryScript() const
+		{
+			return this->entryScript;
+		}
+
+		// The scripts a script can jump to
+		const std::vector<std::size_t> & getSuccessors(std::size_t scriptIndex) const
+		{
+			return this->successors[scriptIndex];
+		}
+
+		bool isReachable(std::size_t scriptIndex) const
+		{
+			return this->reachable[scriptIndex];
+		}
+
+		std::vector<std::size_t> getUnreachable() const
+		{
+			std::vector<std::size_t> unreachable;
+
+			for(std::size_t index = 0; index < this->reachable.size(); ++index)
+				if(!this->reachable[index])
+					unreachable.push_back(index);
+
+			return unreachable;
+		}
+
+		// Reachable scripts in breadth first order from the entry script,
+		// so the scripts a route can load soonest come first
+		const std::vector<std::size_t> & getPreloadOrder() const
+		{
+			return this->preloadOrder;
+		}
+
+		std::size_t getComponentCount() const
+		{
+			return this->componentCount;
+		}
+
+		// Components are numbered in reverse topological order:
+		// no script jumps to a component numbered higher than its own
+		std::size_t getComponent(std::size_t scriptIndex) const
+		{
+			return this->components[scriptIndex];
+		}
+
+		// Scripts grouped by component, each group in index order
+		std::vector<std::vector<std::size_t>> getComponents() const
+		{
+			std::vector<std::vector<std::size_t>> groups(this->componentCount);
+
+			for(std::size_t index = 0; index < this->components.size(); ++index)
+				groups[this->components[index]].push_back(index);
+
+			return groups;
+		}
+
+	private:
+		void findReachable()
+		{
+			this->reachable.assign(this->successors.size(), false);
+
+			if(this->entryScript >= this->successors.size())
+				return;
+
+			this->reachable[this->entryScript] = true;
+			this->preloadOrder.push_back(this->entryScript);
+
+			// preloadOrder doubles as the queue
+			for(std::size_t next = 0; next < this->preloadOrder.size(); ++next)
+				for(const std::size_t target : this->successors[this->preloadOrder[next]])
+					if(!this->reachable[target])
+					{
+						this->reachable[target] = true;
+						this->preloadOrder.push_back(target);
+					}
+		}
+
+		// Tarjan's algorithm with an explicit stack,
+		// so long chains of jumps can't overflow the call stack
+		void findComponents()
+		{
+			const std::size_t count = this->successors.size();
+			const std::size_t none = unvisited;
+
+			std::vector<std::size_t> indices(count, none);
+			std::vector<std::size_t> lowLinks(count, 0);
+			std::vector<bool> isOnStack(count, false);
+			std::vector<std::size_t> stack;
+
+			// Script and position in its successor list
+			std::vector<std::pair<std::size_t, std::size_t>> callStack;
+
+			this->components.assign(count, none);
+			std::size_t nextIndex = 0;
+
+			for(std::size_t root = 0; root < count; ++root)
+			{
+				if(indices[root] != none)
+					continue;
+
+				callStack.emplace_back(root, 0);
+
+				while(!callStack.empty())
+				{
+					const std::size_t script = callStack.back().first;
+					std::size_t & position = callStack.back().second;
+
+					if(position == 0)
+					{
+						indices[script] = nextIndex;
+						lowLinks[script] = nextIndex;
+						++nextIndex;
+
+						stack.push_back(script);
+						isOnStack[script] = true;
+					}
+
+					const auto & targets = this->successors[script];
+
+					if(position < targets.size())
+					{
+						const std::size_t target = targets[position];
+						++position;
+
+						if(indices[target] == none)
+							callStack.emplace_back(target, 0);
+						else if(isOnStack[target])
+							lowLinks[script] = (std::min)(lowLinks[script], indices[target]);
+
+						continue;
+					}
+
+					if(lowLinks[script] == indices[script])
+					{
+						std::size_t member;
+
+						do
+						{
+							member = stack.back();
+							stack.pop_back();
+							isOnStack[member] = false;
+							this->components[member] = this->componentCount;
+						}
+						while(member != script);
+
+						++this->componentCount;
+					}
+
+					callStack.pop_back();
+
+					if(!callStack.empty())
+					{
+						const std::size_t caller = callStack.back().first;
+						lowLinks[caller] = (std::min)(lowLinks[caller], lowLinks[script]);
+					}
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,233 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Script.h"
+#include "../Runtime/VariableValue.h"
+
+namespace VNVita
+{
+	enum class OperandType : std::uint8_t
+	{
+		IntLiteral,
+		StringLiteral,
+		Variable,
+	};
+
+	// The right hand side of a setvar, gsetvar or if.
+	// value is the int itself, an index into the constant pool or a slot.
+	struct Operand
+	{
+		OperandType type;
+		std::int32_t value;
+	};
+
+	// Slot and operand of a setvar, gsetvar, if or random command
+	struct ResolvedVariableCommand
+	{
+		std::uint32_t slot;
+		Operand operand;
+	};
+
+	// Gives every variable name used by a set of scripts a dense slot
+	// and pre-parses every operand, so evaluation never hashes names
+	// or re-parses literals.
+	class VariableResolution
+	{
+	public:
+		static constexpr const char * selectedVariable = "selected";
+
+	private:
+		std::unordered_map<std::string, std::uint32_t> slots;
+		std::vector<std::string> names;
+		std::vector<VariableValue> constants;
+		std::vector<std::vector<ResolvedVariableCommand>> scripts;
+		std::uint32_t selectedSlot = 0;
+
+	public:
+		VariableResolution()
+		{
+			this->selectedSlot = this->getOrAddSlot(selectedVariable);
+		}
+
+		VariableResolution(const std::vector<Script> & scripts) :
+			VariableResolution()
+		{
+			this->scripts.reserve(scripts.size());
+
+			for(const auto & script : scripts)
+				this->addScript(script);
+		}
+
+		std::size_t getSlotCount() const
+		{
+			return this->names.size();
+		}
+
+		const std::string & getName(std::uint32_t slot) const
+		{
+			return this->names[slot];
+		}
+
+		bool tryGetSlot(const std::string & name, std::uint32_t & slot) const
+		{
+			const auto iterator = this->slots.find(name);
+
+			if(iterator == this->slots.end())
+				return false;
+
+			slot = iterator->second;
+			return true;
+		}
+
+		// The slot that choice results are written to
+		std::uint32_t getSelectedSlot() const
+		{
+			return this->selectedSlot;
+		}
+
+		const VariableValue & getConstant(std::int32_t index) const
+		{
+			return this->constants[static_cast<std::size_t>(index)];
+		}
+
+		// Only meaningful for setvar, gsetvar, if and random commands
+		const ResolvedVariableCommand & getCommand(std::size_t scriptIndex, std::size_t commandIndex) const
+		{
+			return this->scripts[scriptIndex][commandIndex];
+		}
+
+	private:
+		std::uint32_t getOrAddSlot(const std::string & name)
+		{
+			const auto result = this->slots.emplace(name, static_cast<std::uint32_t>(this->names.size()));
+
+			if(result.second)
+				this->names.push_back(name);
+
+			return result.first->second;
+		}
+
+		void addScript(const Script & script)
+		{
+			std::vector<ResolvedVariableCommand> resolved(script.size(), ResolvedVariableCommand { 0, Operand { OperandType::IntLiteral, 0 } });
+
+			for(std::size_t index = 0; index < script.size(); ++index)
+			{
+				const Command & command = script.getCommand(index);
+
+				switch(command.getKind())
+				{
+				case CommandKind::SetLocalVariable:
+					{
+						const auto & setCommand = cast<SetLocalVariableCommand>(command);
+						resolved[index] = { this->getOrAddSlot(setCommand.getLeft()), this->resolveOperand(setCommand.getRight()) };
+					}
+					break;
+
+				case CommandKind::SetGlobalVariable:
+					{
+						const auto & setCommand = cast<SetGlobalVariableCommand>(command);
+						resolved[index] = { this->getOrAddSlot(setCommand.getLeft()), this->resolveOperand(setCommand.getRight()) };
+					}
+					break;
+
+				case CommandKind::If:
+					{
+						const auto & ifCommand = cast<IfCommand>(command);
+						resolved[index] = { this->getOrAddSlot(ifCommand.getLeft()), this->resolveOperand(ifCommand.getRight()) };
+					}
+					break;
+
+				case CommandKind::Random:
+					resolved[index].slot = this->getOrAddSlot(cast<RandomCommand>(command).getVariable());
+					break;
+
+				default:
+					break;
+				}
+			}
+
+			this->scripts.push_back(std::move(resolved));
+		}
+
+		// An operand is a quoted string, an int or the name of a variable
+		Operand resolveOperand(const std::string & operand)
+		{
+			const auto first = operand.find_first_not_of(" \t\r");
+			if(first == std::string::npos)
+				return Operand { OperandType::IntLiteral, 0 };
+
+			const auto last = operand.find_last_not_of(" \t\r");
+			const std::string text = operand.substr(first, (last - first) + 1);
+
+			if((text.size() >= 2) && (text.front() == '"') && (text.back() == '"'))
+			{
+				this->constants.emplace_back(text.substr(1, text.size() - 2));
+				return Operand { OperandType::StringLiteral, static_cast<std::int32_t>(this->constants.size() - 1) };
+			}
+
+			int value;
+			if(tryParseInt(text, value))
+				return Operand { OperandType::IntLiteral, value };
+
+			return Operand { OperandType::Variable, static_cast<std::int32_t>(this->getOrAddSlot(text)) };
+		}
+
+		static bool tryParseInt(const std::string & text, int & result)
+		{
+			std::size_t index = ((text[0] == '-') || (text[0] == '+')) ? 1 : 0;
+
+			if(index >= text.size())
+				return false;
+
+			const bool isNegative = (text[0] == '-');
+
+			// Built up as a negative number, which reaches one further than a positive one
+			const int limit = isNegative ? (std::numeric_limits<int>::min)() : -(std::numeric_limits<int>::max)();
+
+			int value = 0;
+
+			for(; index < text.size(); ++index)
+			{
+				const char c = text[index];
+
+				if((c < '0') || (c > '9'))
+					return false;
+
+				const int digit = (c - '0');
+
+				// Too long for an int, so it's taken as a name
+				if(value < ((limit + digit) / 10))
+					return false;
+
+				value = ((value * 10) - digit);
+			}
+
+			result = isNegative ? value : -value;
+			return true;
+		}
+	};
+}
\ No newline at end of file
@@ -24,6 +24,14 @@ namespace VNVita
 	class AwaitInputCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::AwaitInput;
+
+	public:
+		AwaitInputCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitAwaitInputCommand(*this);
@@ -25,6 +25,9 @@ namespace VNVita
 {
 	class BackgroundLoadCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::BackgroundLoad;
+
 	private:
 		static constexpr int defaultFadeTime = -1;
 
@@ -34,12 +37,12 @@ namespace VNVita
 
 	public:
 		BackgroundLoadCommand(const std::string & path, int fadeTime = defaultFadeTime) :
-			path(path), fadeTime(fadeTime)
+			Command(commandKind), path(path), fadeTime(fadeTime)
 		{
 		}
 
 		BackgroundLoadCommand(std::string && path, int fadeTime = defaultFadeTime) :
-			path(path), fadeTime(fadeTime)
+			Command(commandKind), path(path), fadeTime(fadeTime)
 		{
 		}
 
@@ -26,17 +26,20 @@ namespace VNVita
 {
 	class ChoiceCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::Choice;
+
 	private:
 		std::vector<std::string> choices;
 
 	public:
 		ChoiceCommand(const std::vector<std::string> & choices) :
-			choices(choices)
+			Command(commandKind), choices(choices)
 		{
 		}
 
 		ChoiceCommand(std::vector<std::string> && choices) :
-			choices(choices)
+			Command(commandKind), choices(choices)
 		{
 		}
 
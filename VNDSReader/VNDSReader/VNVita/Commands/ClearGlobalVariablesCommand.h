@@ -24,6 +24,14 @@ namespace VNVita
 	class ClearGlobalVariablesCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::ClearGlobalVariables;
+
+	public:
+		ClearGlobalVariablesCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitClearGlobalVariablesCommand(*this);
@@ -24,6 +24,14 @@ namespace VNVita
 	class ClearLocalVariablesCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::ClearLocalVariables;
+
+	public:
+		ClearLocalVariablesCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitClearLocalVariablesCommand(*this);
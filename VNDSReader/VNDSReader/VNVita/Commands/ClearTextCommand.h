@@ -24,6 +24,14 @@ namespace VNVita
 	class ClearTextCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::ClearText;
+
+	public:
+		ClearTextCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitClearTextCommand(*this);
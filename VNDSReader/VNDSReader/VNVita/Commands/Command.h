@@ -16,15 +16,31 @@
 //  limitations under the License.
 //
 
+#include "CommandKind.h"
+
 namespace VNVita
 {
 	class CommandVisitor;
 
 	class Command
 	{
+	private:
+		CommandKind kind;
+
+	protected:
+		Command(CommandKind kind) :
+			kind(kind)
+		{
+		}
+
 	public:
 		virtual ~Command() = default;
 
+		CommandKind getKind() const
+		{
+			return this->kind;
+		}
+
 		virtual void accept(CommandVisitor & visitor) = 0;
 	};
 }
\ No newline at end of file
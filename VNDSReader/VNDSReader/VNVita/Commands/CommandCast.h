@@ -0,0 +1,65 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cassert>
+
+#include "Command.h"
+
+namespace VNVita
+{
+	// Kind-tag based replacements for dynamic_cast.
+	// CommandType must declare a static commandKind member.
+
+	template< typename CommandType >
+	bool isa(const Command & command)
+	{
+		return (command.getKind() == CommandType::commandKind);
+	}
+
+	template< typename CommandType >
+	bool isa(const Command * command)
+	{
+		return ((command != nullptr) && isa<CommandType>(*command));
+	}
+
+	template< typename CommandType >
+	CommandType & cast(Command & command)
+	{
+		assert(isa<CommandType>(command));
+		return static_cast<CommandType &>(command);
+	}
+
+	template< typename CommandType >
+	const CommandType & cast(const Command & command)
+	{
+		assert(isa<CommandType>(command));
+		return static_cast<const CommandType &>(command);
+	}
+
+	template< typename CommandType >
+	CommandType * tryCast(Command * command)
+	{
+		return isa<CommandType>(command) ? static_cast<CommandType *>(command) : nullptr;
+	}
+
+	template< typename CommandType >
+	const CommandType * tryCast(const Command * command)
+	{
+		return isa<CommandType>(command) ? static_cast<const CommandType *>(command) : nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VNVita
+{
+	// One tag per concrete command class, in CommandVisitor order.
+	// Stored in every Command so kind checks don't need RTTI.
+	enum class CommandKind : std::uint8_t
+	{
+		Skip,
+		EndScript,
+		BackgroundLoad,
+		SetImage,
+		Choice,
+		Jump,
+		Delay,
+		Random,
+		Label,
+		GoTo,
+		ClearText,
+		If,
+		Fi,
+		AwaitInput,
+		Text,
+		SetLocalVariable,
+		ClearLocalVariables,
+		SetGlobalVariable,
+		ClearGlobalVariables,
+		PlayMusic,
+		StopMusic,
+		PlaySound,
+		StopSound,
+	};
+
+	constexpr std::size_t commandKindCount = (static_cast<std::size_t>(CommandKind::StopSound) + 1);
+
+	inline const char * getCommandKindName(CommandKind kind)
+	{
+		switch(kind)
+		{
+		case CommandKind::Skip: return "Skip";
+		case CommandKind::EndScript: return "EndScript";
+		case CommandKind::BackgroundLoad: return "BackgroundLoad";
+		case CommandKind::SetImage: return "SetImage";
+		case CommandKind::Choice: return "Choice";
+		case CommandKind::Jump: return "Jump";
+		case CommandKind::Delay: return "Delay";
+		case CommandKind::Random: return "Random";
+		case CommandKind::Label: return "Label";
+		case CommandKind::GoTo: return "GoTo";
+		case CommandKind::ClearText: return "ClearText";
+		case CommandKind::If: return "If";
+		case CommandKind::Fi: return "Fi";
+		case CommandKind::AwaitInput: return "AwaitInput";
+		case CommandKind::Text: return "Text";
+		case CommandKind::SetLocalVariable: return "SetLocalVariable";
+		case CommandKind::ClearLocalVariables: return "ClearLocalVariables";
+		case CommandKind::SetGlobalVariable: return "SetGlobalVariable";
+		case CommandKind::ClearGlobalVariables: return "ClearGlobalVariables";
+		case CommandKind::PlayMusic: return "PlayMusic";
+		case CommandKind::StopMusic: return "StopMusic";
+		case CommandKind::PlaySound: return "PlaySound";
+		case CommandKind::StopSound: return "StopSound";
+		default: return "";
+		}
+	}
+}
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "CommandKind.h"
 #include "Command.h"
+#include "CommandCast.h"
 #include "CommandVisitor.h"
 
 #include "Operations.h"
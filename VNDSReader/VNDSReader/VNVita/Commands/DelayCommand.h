@@ -23,12 +23,15 @@ namespace VNVita
 {
 	class DelayCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::Delay;
+
 	private:
 		int time;
 
 	public:
 		DelayCommand(int time) :
-			time(time)
+			Command(commandKind), time(time)
 		{
 		}
 
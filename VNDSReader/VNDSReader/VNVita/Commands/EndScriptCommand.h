@@ -24,6 +24,14 @@ namespace VNVita
 	class EndScriptCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::EndScript;
+
+	public:
+		EndScriptCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitEndScriptCommand(*this);
@@ -24,6 +24,14 @@ namespace VNVita
 	class FiCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::Fi;
+
+	public:
+		FiCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitFiCommand(*this);
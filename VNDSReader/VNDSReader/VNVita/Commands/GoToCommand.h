@@ -25,17 +25,20 @@ namespace VNVita
 {
 	class GoToCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::GoTo;
+
 	private:
 		std::string label;
 
 	public:
 		GoToCommand(const std::string & label) :
-			label(label)
+			Command(commandKind), label(label)
 		{
 		}
 
 		GoToCommand(std::string && label) :
-			label(label)
+			Command(commandKind), label(label)
 		{
 		}
 
@@ -26,6 +26,9 @@ namespace VNVita
 {
 	class IfCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::If;
+
 	private:
 		std::string left;
 		IfOperation operation;
@@ -33,22 +36,22 @@ namespace VNVita
 
 	public:
 		IfCommand(const std::string & left, IfOperation operation, const std::string & right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		IfCommand(const std::string & left, IfOperation operation, std::string && right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		IfCommand(std::string && left, IfOperation operation, const std::string & right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		IfCommand(std::string && left, IfOperation operation, std::string && right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
@@ -25,38 +25,41 @@ namespace VNVita
 {
 	class JumpCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::Jump;
+
 	private:
 		std::string path;
 		std::string label;
 
 	public:
 		JumpCommand(const std::string & path) :
-			path(path)
+			Command(commandKind), path(path)
 		{
 		}
 
 		JumpCommand(std::string && path) :
-			path(path)
+			Command(commandKind), path(path)
 		{
 		}
 
 		JumpCommand(const std::string & path, const std::string & label) :
-			path(path), label(label)
+			Command(commandKind), path(path), label(label)
 		{
 		}
 
 		JumpCommand(std::string && path, std::string && label) :
-			path(path), label(label)
+			Command(commandKind), path(path), label(label)
 		{
 		}
 
 		JumpCommand(const std::string & path, std::string && label) :
-			path(path), label(label)
+			Command(commandKind), path(path), label(label)
 		{
 		}
 
 		JumpCommand(std::string && path, const std::string & label) :
-			path(path), label(label)
+			Command(commandKind), path(path), label(label)
 		{
 		}
 
@@ -25,17 +25,20 @@ namespace VNVita
 {
 	class LabelCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::Label;
+
 	private:
 		std::string label;
 
 	public:
 		LabelCommand(const std::string & label) :
-			label(label)
+			Command(commandKind), label(label)
 		{
 		}
 
 		LabelCommand(std::string && label) :
-			label(label)
+			Command(commandKind), label(label)
 		{
 		}
 
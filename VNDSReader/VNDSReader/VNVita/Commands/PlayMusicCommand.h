@@ -25,17 +25,20 @@ namespace VNVita
 {
 	class PlayMusicCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::PlayMusic;
+
 	private:
 		std::string path;
 
 	public:
 		PlayMusicCommand(const std::string & path) :
-			path(path)
+			Command(commandKind), path(path)
 		{
 		}
 
 		PlayMusicCommand(std::string && path) :
-			path(path)
+			Command(commandKind), path(path)
 		{
 		}
 
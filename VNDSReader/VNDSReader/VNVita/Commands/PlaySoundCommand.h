@@ -25,6 +25,9 @@ namespace VNVita
 {
 	class PlaySoundCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::PlaySound;
+
 	private:
 		static constexpr int defaultRepeats = 1;
 
@@ -34,12 +37,12 @@ namespace VNVita
 
 	public:
 		PlaySoundCommand(const std::string & path, int repeats = defaultRepeats) :
-			path(path), repeats(repeats)
+			Command(commandKind), path(path), repeats(repeats)
 		{
 		}
 
 		PlaySoundCommand(std::string && path, int repeats = defaultRepeats) :
-			path(path), repeats(repeats)
+			Command(commandKind), path(path), repeats(repeats)
 		{
 		}
 
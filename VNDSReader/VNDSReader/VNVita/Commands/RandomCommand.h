@@ -25,6 +25,9 @@ namespace VNVita
 {
 	class RandomCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::Random;
+
 	private:
 		std::string variable;
 		int low;
@@ -32,12 +35,12 @@ namespace VNVita
 
 	public:
 		RandomCommand(const std::string & variable, int low, int high) :
-			variable(variable), low(low), high(high)
+			Command(commandKind), variable(variable), low(low), high(high)
 		{
 		}
 
 		RandomCommand(std::string && variable, int low, int high) :
-			variable(variable), low(low), high(high)
+			Command(commandKind), variable(variable), low(low), high(high)
 		{
 		}
 
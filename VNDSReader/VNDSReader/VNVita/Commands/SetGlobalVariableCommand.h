@@ -26,6 +26,9 @@ namespace VNVita
 {
 	class SetGlobalVariableCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::SetGlobalVariable;
+
 	private:
 		std::string left;
 		SetOperation operation;
@@ -33,22 +36,22 @@ namespace VNVita
 
 	public:
 		SetGlobalVariableCommand(const std::string & left, SetOperation operation, const std::string & right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		SetGlobalVariableCommand(const std::string & left, SetOperation operation, std::string && right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		SetGlobalVariableCommand(std::string && left, SetOperation operation, const std::string & right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		SetGlobalVariableCommand(std::string && left, SetOperation operation, std::string && right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
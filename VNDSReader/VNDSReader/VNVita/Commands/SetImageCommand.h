@@ -25,6 +25,9 @@ namespace VNVita
 {
 	class SetImageCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::SetImage;
+
 	private:
 		std::string path;
 		int x;
@@ -32,12 +35,12 @@ namespace VNVita
 
 	public:
 		SetImageCommand(const std::string & variable, int x, int y) :
-			path(variable), x(x), y(y)
+			Command(commandKind), path(variable), x(x), y(y)
 		{
 		}
 
 		SetImageCommand(std::string && variable, int x, int y) :
-			path(variable), x(x), y(y)
+			Command(commandKind), path(variable), x(x), y(y)
 		{
 		}
 
@@ -26,6 +26,9 @@ namespace VNVita
 {
 	class SetLocalVariableCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::SetLocalVariable;
+
 	private:
 		std::string left;
 		SetOperation operation;
@@ -33,22 +36,22 @@ namespace VNVita
 
 	public:
 		SetLocalVariableCommand(const std::string & left, SetOperation operation, const std::string & right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		SetLocalVariableCommand(const std::string & left, SetOperation operation, std::string && right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		SetLocalVariableCommand(std::string && left, SetOperation operation, const std::string & right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
 		SetLocalVariableCommand(std::string && left, SetOperation operation, std::string && right) :
-			left(left), operation(operation), right(right)
+			Command(commandKind), left(left), operation(operation), right(right)
 		{
 		}
 
@@ -24,6 +24,14 @@ namespace VNVita
 	class SkipCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::Skip;
+
+	public:
+		SkipCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitSkipCommand(*this);
@@ -24,6 +24,14 @@ namespace VNVita
 	class StopMusicCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::StopMusic;
+
+	public:
+		StopMusicCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitStopMusicCommand(*this);
@@ -24,6 +24,14 @@ namespace VNVita
 	class StopSoundCommand : public Command
 	{
 	public:
+		static constexpr CommandKind commandKind = CommandKind::StopSound;
+
+	public:
+		StopSoundCommand() :
+			Command(commandKind)
+		{
+		}
+
 		void accept(CommandVisitor & visitor) override
 		{
 			visitor.visitStopSoundCommand(*this);
@@ -26,18 +26,21 @@ namespace VNVita
 {
 	class TextCommand : public Command
 	{
+	public:
+		static constexpr CommandKind commandKind = CommandKind::Text;
+
 	private:
 		std::string text;
 		TextOption option;
 
 	public:
 		TextCommand(const std::string & text, TextOption option) :
-			text(text), option(option)
+			Command(commandKind), text(text), option(option)
 		{
 		}
 
 		TextCommand(std::string && text, TextOption option) :
-			text(text), option(option)
+			Command(commandKind), text(text), option(option)
 		{
 		}
 
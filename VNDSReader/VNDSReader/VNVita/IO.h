@@ -0,0 +1 @@
+#include "IO\IO.h"
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include "ReadQueue.h"
+
+namespace VNVita
+{
+	struct FileWrite
+	{
+		std::string path;
+		std::string content;
+
+		// Text is written with the platform's line endings
+		bool isBinary;
+
+		// Set by FileIO::writeFiles
+		bool isWritten;
+	};
+
+	// A way of reading and writing many whole files at once
+	class FileIO
+	{
+	public:
+		virtual ~FileIO() = default;
+
+		virtual const char * getName() const = 0;
+
+		// Pushes every file to the queue as soon as it has been read,
+		// but leaves closing the queue to the caller
+		virtual void readFiles(const std::vector<std::string> & paths, ReadQueue & queue) = 0;
+
+		virtual void writeFiles(std::vector<FileWrite> & writes) = 0;
+	};
+}
\ No newline at end of file
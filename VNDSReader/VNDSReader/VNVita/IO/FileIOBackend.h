@@ -0,0 +1,72 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "FileIO.h"
+#include "StreamFileIO.h"
+#include "UringFileIO.h"
+
+namespace VNVita
+{
+	enum class FileIOBackend : std::uint8_t
+	{
+		Stream,
+		IoUring,
+	};
+
+	// Accepts the names used on the command line: stream and uring
+	inline bool tryParseFileIOBackend(const std::string & name, FileIOBackend & backend)
+	{
+		if(name == "stream")
+		{
+			backend = FileIOBackend::Stream;
+			return true;
+		}
+
+		if(name == "uring")
+		{
+			backend = FileIOBackend::IoUring;
+			return true;
+		}
+
+		return false;
+	}
+
+	// Falls back to streams where io_uring can't be had: on other
+	// platforms, on kernels before 5.6 and where it's been turned off.
+	// Check getName to see which was made.
+	inline std::unique_ptr<FileIO> makeFileIO(FileIOBackend backend)
+	{
+#if defined(__linux__)
+		if(backend == FileIOBackend::IoUring)
+		{
+			auto fileIO = std::make_unique<UringFileIO>();
+
+			if(fileIO->tryOpen())
+				return fileIO;
+		}
+#else
+		static_cast<void>(backend);
+#endif
+
+		return std::make_unique<StreamFileIO>();
+	}
+}
\ No newline at end of file
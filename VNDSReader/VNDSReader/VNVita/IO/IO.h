@@ -0,0 +1,9 @@
+#pragma once
+
+#include "FileIO.h"
+#include "ReadQueue.h"
+#include "StreamFileIO.h"
+#include "IoUring.h"
+#include "UringFileIO.h"
+#include "FileIOBackend.h"
+#include "PageCache.h"
\ No newline at end of file
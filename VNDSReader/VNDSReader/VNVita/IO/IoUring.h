@@ -0,0 +1,281 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace VNVita
+{
+	// An io_uring instance driven through the system calls themselves,
+	// so there's no library to link. Entries are prepared with
+	// getSubmission, sent with trySubmitAndWait and collected
+	// with tryPopCompletion.
+	class IoUring
+	{
+	private:
+		int ring = -1;
+
+		void * submissionMap = MAP_FAILED;
+		void * completionMap = MAP_FAILED;
+		void * submissionEntryMap = MAP_FAILED;
+		std::size_t submissionMapSize = 0;
+		std::size_t completionMapSize = 0;
+		std::size_t submissionEntryMapSize = 0;
+
+		unsigned * submissionHead = nullptr;
+		unsigned * submissionTail = nullptr;
+		unsigned * submissionArray = nullptr;
+		unsigned submissionMask = 0;
+		unsigned submissionCapacity = 0;
+		io_uring_sqe * submissionEntries = nullptr;
+
+		unsigned * completionHead = nullptr;
+		unsigned * completionTail = nullptr;
+		unsigned completionMask = 0;
+		io_uring_cqe * completionEntries = nullptr;
+
+		// Prepared but not yet given to the kernel
+		unsigned preparedCount = 0;
+
+		// Taken by the kernel but not yet popped
+		unsigned inFlightCount = 0;
+
+	public:
+		IoUring() = default;
+
+		IoUring(const IoUring &) = delete;
+		IoUring & operator =(const IoUring &) = delete;
+
+		~IoUring()
+		{
+			this->close();
+		}
+
+		bool isOpen() const
+		{
+			return (this->ring >= 0);
+		}
+
+		// How many entries can be prepared before submitting
+		unsigned getCapacity() const
+		{
+			return this->submissionCapacity;
+		}
+
+		bool tryOpen(unsigned entryCount)
+		{
+			this->close();
+
+			io_uring_params parameters;
+			std::memset(&parameters, 0, sizeof(parameters));
+
+			const long result = syscall(__NR_io_uring_setup, entryCount, &parameters);
+			if(result < 0)
+				return false;
+
+			this->ring = static_cast<int>(result);
+
+			this->submissionMapSize = (parameters.sq_off.array + (parameters.sq_entries * sizeof(unsigned)));
+			this->completionMapSize = (parameters.cq_off.cqes + (parameters.cq_entries * sizeof(io_uring_cqe)));
+			this->submissionEntryMapSize = (parameters.sq_entries * sizeof(io_uring_sqe));
+
+			// Since 5.4 both rings share one mapping
+			const bool isSingleMap = ((parameters.features & IORING_FEAT_SINGLE_MMAP) != 0);
+
+			if(isSingleMap)
+			{
+				if(this->completionMapSize > this->submissionMapSize)
+					this->submissionMapSize = this->completionMapSize;
+
+				this->completionMapSize = 0;
+			}
+
+			this->submissionMap = mmap(nullptr, this->submissionMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring, IORING_OFF_SQ_RING);
+			if(this->submissionMap == MAP_FAILED)
+			{
+				this->close();
+				return false;
+			}
+
+			if(!isSingleMap)
+			{
+				this->completionMap = mmap(nullptr, this->completionMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring, IORING_OFF_CQ_RING);
+				if(this->completionMap == MAP_FAILED)
+				{
+					this->close();
+					return false;
+				}
+			}
+
+			this->submissionEntryMap = mmap(nullptr, this->submissionEntryMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, this->ring, IORING_OFF_SQES);
+			if(this->submissionEntryMap == MAP_FAILED)
+			{
+				this->close();
+				return false;
+			}
+
+			char * const submissionRing = static_cast<char *>(this->submissionMap);
+			char * const completionRing = static_cast<char *>(isSingleMap ? this->submissionMap : this->completionMap);
+
+			this->submissionHead = reinterpret_cast<unsigned *>(submissionRing + parameters.sq_off.head);
+			this->submissionTail = reinterpret_cast<unsigned *>(submissionRing + parameters.sq_off.tail);
+			this->submissionArray = reinterpret_cast<unsigned *>(submissionRing + parameters.sq_off.array);
+			this->submissionMask = *reinterpret_cast<unsigned *>(submissionRing + parameters.sq_off.ring_mask);
+			this->submissionCapacity = parameters.sq_entries;
+			this->submissionEntries = static_cast<io_uring_sqe *>(this->submissionEntryMap);
+
+			this->completionHead = reinterpret_cast<unsigned *>(completionRing + parameters.cq_off.head);
+			this->completionTail = reinterpret_cast<unsigned *>(completionRing + parameters.cq_off.tail);
+			this->completionMask = *reinterpret_cast<unsigned *>(completionRing + parameters.cq_off.ring_mask);
+			this->completionEntries = reinterpret_cast<io_uring_cqe *>(completionRing + parameters.cq_off.cqes);
+
+			return true;
+		}
+
+		// Whether the kernel knows every one of the operations
+		bool supports(std::initializer_list<std::uint8_t> operations) const
+		{
+			const unsigned operationCapacity = 256;
+
+			std::vector<unsigned char> buffer(sizeof(io_uring_probe) + (operationCapacity * sizeof(io_uring_probe_op)), 0);
+			io_uring_probe * const probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+
+			// Probing arrived with 5.6, along with most of the file operations
+			if(syscall(__NR_io_uring_register, this->ring, IORING_REGISTER_PROBE, probe, operationCapacity) < 0)
+				return false;
+
+			for(const std::uint8_t operation : operations)
+				if((operation > probe->last_op) || ((probe->ops[operation].flags & IO_URING_OP_SUPPORTED) == 0))
+					return false;
+
+			return true;
+		}
+
+		// A cleared entry to fill in, or nullptr if the ring is full
+		io_uring_sqe * getSubmission()
+		{
+			if(this->preparedCount >= this->submissionCapacity)
+				return nullptr;
+
+			// Only this side moves the tail, so it needs no atomic read
+			const unsigned index = ((*this->submissionTail + this->preparedCount) & this->submissionMask);
+
+			io_uring_sqe * const entry = &this->submissionEntries[index];
+			std::memset(entry, 0, sizeof(*entry));
+
+			this->submissionArray[index] = index;
+			++this->preparedCount;
+
+			return entry;
+		}
+
+		// Gives the prepared entries to the kernel and waits until
+		// at least waitCount completions are ready to be popped
+		bool trySubmitAndWait(unsigned waitCount)
+		{
+			__atomic_store_n(this->submissionTail, (*this->submissionTail + this->preparedCount), __ATOMIC_RELEASE);
+			this->preparedCount = 0;
+
+			while(true)
+			{
+				const unsigned pendingCount = (*this->submissionTail - __atomic_load_n(this->submissionHead, __ATOMIC_ACQUIRE));
+				const long result = syscall(__NR_io_uring_enter, this->ring, pendingCount, waitCount, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+				if(result < 0)
+				{
+					if(errno != EINTR)
+						return false;
+
+					continue;
+				}
+
+				this->inFlightCount += static_cast<unsigned>(result);
+
+				// The kernel only waits once everything has been submitted
+				if(static_cast<unsigned>(result) == pendingCount)
+					return true;
+			}
+		}
+
+		// Waits until every entry the kernel has taken has completed,
+		// after which none of their buffers are in use
+		bool tryWaitForAll()
+		{
+			while(true)
+			{
+				if(syscall(__NR_io_uring_enter, this->ring, 0, this->inFlightCount, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0)
+					return true;
+
+				if(errno != EINTR)
+					return false;
+			}
+		}
+
+		bool tryPopCompletion(io_uring_cqe & completion)
+		{
+			// Only this side moves the head
+			const unsigned head = *this->completionHead;
+
+			if(head == __atomic_load_n(this->completionTail, __ATOMIC_ACQUIRE))
+				return false;
+
+			completion = this->completionEntries[head & this->completionMask];
+			__atomic_store_n(this->completionHead, (head + 1), __ATOMIC_RELEASE);
+
+			--this->inFlightCount;
+
+			return true;
+		}
+
+		void close()
+		{
+			if(this->submissionEntryMap != MAP_FAILED)
+				munmap(this->submissionEntryMap, this->submissionEntryMapSize);
+
+			if(this->completionMap != MAP_FAILED)
+				munmap(this->completionMap, this->completionMapSize);
+
+			if(this->submissionMap != MAP_FAILED)
+				munmap(this->submissionMap, this->submissionMapSize);
+
+			if(this->ring >= 0)
+				::close(this->ring);
+
+			this->ring = -1;
+			this->submissionMap = MAP_FAILED;
+			this->completionMap = MAP_FAILED;
+			this->submissionEntryMap = MAP_FAILED;
+			this->submissionCapacity = 0;
+			this->preparedCount = 0;
+			this->inFlightCount = 0;
+		}
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <string>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace VNVita
+{
+	// Asks the kernel to drop a file's cached pages, so the next read
+	// has to go to the disk. Only pages that have been written back can
+	// be dropped, and only Linux is asked. Needs no special permissions,
+	// unlike dropping the whole cache.
+	inline bool tryEvictFromPageCache(const std::string & path)
+	{
+#if defined(__linux__)
+		const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if(file < 0)
+			return false;
+
+		const bool isEvicted = (fdatasync(file) == 0) && (posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0);
+
+		close(file);
+		return isEvicted;
+#else
+		static_cast<void>(path);
+		return false;
+#endif
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace VNVita
+{
+	struct FileRead
+	{
+		// Position of the path in the list that was read
+		std::size_t index;
+
+		bool isRead;
+		std::string content;
+	};
+
+	// Hands files from the thread reading them to the threads parsing them,
+	// in the order the reads complete
+	class ReadQueue
+	{
+	private:
+		std::mutex mutex;
+		std::condition_variable available;
+		std::deque<FileRead> reads;
+		bool isClosed = false;
+
+	public:
+		void push(FileRead && read)
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->reads.push_back(std::move(read));
+			}
+
+			this->available.notify_one();
+		}
+
+		// Called once nothing more will be pushed
+		void close()
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->isClosed = true;
+			}
+
+			this->available.notify_all();
+		}
+
+		// Waits for the next read, false once the queue is closed and empty
+		bool tryPop(FileRead & read)
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+
+			this->available.wait(lock, [this]() { return !this->reads.empty() || this->isClosed; });
+
+			if(this->reads.empty())
+				return false;
+
+			read = std::move(this->reads.front());
+			this->reads.pop_front();
+			return true;
+		}
+	};
+}
\ No newline at end of file
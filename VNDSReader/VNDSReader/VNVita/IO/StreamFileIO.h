@@ -0,0 +1,76 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "FileIO.h"
+
+namespace VNVita
+{
+	// One file at a time through std::ifstream and std::ofstream,
+	// works everywhere
+	class StreamFileIO : public FileIO
+	{
+	public:
+		const char * getName() const override
+		{
+			return "stream";
+		}
+
+		void readFiles(const std::vector<std::string> & paths, ReadQueue & queue) override
+		{
+			for(std::size_t index = 0; index < paths.size(); ++index)
+				queue.push(readFile(paths[index], index));
+		}
+
+		void writeFiles(std::vector<FileWrite> & writes) override
+		{
+			for(auto & write : writes)
+				writeFile(write);
+		}
+
+	public:
+		static FileRead readFile(const std::string & path, std::size_t index)
+		{
+			// Text mode, the same as loadScript
+			std::ifstream file(path);
+
+			FileRead read { index, static_cast<bool>(file), std::string() };
+
+			if(read.isRead)
+			{
+				read.content.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+				read.isRead = !file.bad();
+			}
+
+			return read;
+		}
+
+		static void writeFile(FileWrite & write)
+		{
+			std::ofstream file(write.path, write.isBinary ? (std::ios::out | std::ios::binary) : std::ios::out);
+			file.write(write.content.data(), static_cast<std::streamsize>(write.content.size()));
+			file.close();
+
+			write.isWritten = static_cast<bool>(file);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,359 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "FileIO.h"
+#include "IoUring.h"
+#include "StreamFileIO.h"
+
+namespace VNVita
+{
+	// Reads and writes files a batch at a time through io_uring.
+	// Every file of a batch is opened by one system call, read or
+	// written by another and closed by a third, where streams would
+	// make several calls for each file in turn.
+	//
+	// Needs Linux 5.6 or later, check tryOpen before using it.
+	// If the ring fails part way, the rest goes through StreamFileIO.
+	class UringFileIO : public FileIO
+	{
+	public:
+		static constexpr unsigned defaultQueueDepth = 128;
+
+	private:
+		struct BatchFile
+		{
+			const char * path;
+			int descriptor;
+			bool isFailed;
+
+			char * buffer;
+			std::size_t size;
+
+			// How much has been read or written so far
+			std::size_t offset;
+		};
+
+	private:
+		IoUring ring;
+		bool isBroken = false;
+		std::vector<BatchFile> files;
+		std::vector<struct statx> statuses;
+
+	public:
+		bool tryOpen(unsigned queueDepth = defaultQueueDepth)
+		{
+			if(!this->ring.tryOpen(queueDepth))
+				return false;
+
+			if(!this->ring.supports({ IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE }))
+			{
+				this->ring.close();
+				return false;
+			}
+
+			return true;
+		}
+
+		const char * getName() const override
+		{
+			return "io_uring";
+		}
+
+		void readFiles(const std::vector<std::string> & paths, ReadQueue & queue) override
+		{
+			// Opening takes two entries for each file, the open and the statx
+			const std::size_t batchSize = (this->ring.getCapacity() / 2);
+
+			std::vector<std::string> contents;
+
+			for(std::size_t first = 0; first < paths.size(); first += batchSize)
+			{
+				if(this->isBroken)
+				{
+					for(std::size_t index = first; index < paths.size(); ++index)
+						queue.push(StreamFileIO::readFile(paths[index], index));
+
+					return;
+				}
+
+				const std::size_t count = (std::min)(batchSize, (paths.size() - first));
+
+				this->files.clear();
+				this->statuses.resize(count);
+				contents.resize(count);
+
+				for(std::size_t index = 0; index < count; ++index)
+					this->files.push_back(BatchFile { paths[first + index].c_str(), -1, false, nullptr, 0, 0 });
+
+				this->openFiles(O_RDONLY, true);
+
+				for(std::size_t index = 0; index < count; ++index)
+				{
+					BatchFile & file = this->files[index];
+
+					contents[index].clear();
+
+					if(file.isFailed)
+						continue;
+
+					file.size = static_cast<std::size_t>(this->statuses[index].stx_size);
+					contents[index].resize(file.size);
+					file.buffer = &contents[index][0];
+				}
+
+				this->transferFiles(IORING_OP_READ);
+
+				// Nothing of the batch has been handed on yet, so it's read again
+				if(this->isBroken)
+				{
+					this->closeFiles();
+
+					for(std::size_t index = first; index < (first + count); ++index)
+						queue.push(StreamFileIO::readFile(paths[index], index));
+
+					continue;
+				}
+
+				// Hand the batch on before closing, the descriptors aren't needed
+				for(std::size_t index = 0; index < count; ++index)
+				{
+					const BatchFile & file = this->files[index];
+
+					// A file that shrank since statx ends early
+					contents[index].resize(file.offset);
+
+					queue.push(FileRead { (first + index), !file.isFailed, std::move(contents[index]) });
+				}
+
+				this->closeFiles();
+			}
+		}
+
+		void writeFiles(std::vector<FileWrite> & writes) override
+		{
+			const std::size_t batchSize = this->ring.getCapacity();
+
+			for(std::size_t first = 0; first < writes.size(); first += batchSize)
+			{
+				if(this->isBroken)
+				{
+					for(std::size_t index = first; index < writes.size(); ++index)
+						StreamFileIO::writeFile(writes[index]);
+
+					return;
+				}
+
+				const std::size_t count = (std::min)(batchSize, (writes.size() - first));
+
+				this->files.clear();
+
+				// Line endings need no translating on Linux, text and binary are written alike
+				for(std::size_t index = 0; index < count; ++index)
+				{
+					FileWrite & write = writes[first + index];
+					this->files.push_back(BatchFile { write.path.c_str(), -1, false, &write.content[0], write.content.size(), 0 });
+				}
+
+				this->openFiles(O_WRONLY | O_CREAT | O_TRUNC, false);
+				this->transferFiles(IORING_OP_WRITE);
+				this->closeFiles();
+
+				// Writing the whole batch again is harmless
+				for(std::size_t index = 0; index < count; ++index)
+				{
+					if(this->isBroken)
+						StreamFileIO::writeFile(writes[first + index]);
+					else
+						writes[first + index].isWritten = !this->files[index].isFailed;
+				}
+			}
+		}
+
+	private:
+		// Sends the prepared entries and passes every completion to handle.
+		//
+		// If submitting fails, entries the kernel already took may still be
+		// using the batch's buffers and descriptors, so they're waited out
+		// and handled before this returns. The ring is then closed for good.
+		template<typename Handler>
+		void complete(unsigned count, Handler handle)
+		{
+			if(!this->ring.trySubmitAndWait(count))
+			{
+				this->isBroken = true;
+
+				// Only fails if the ring itself is gone
+				this->ring.tryWaitForAll();
+			}
+
+			io_uring_cqe completion;
+			while(this->ring.tryPopCompletion(completion))
+				handle(completion);
+
+			if(this->isBroken)
+				this->ring.close();
+		}
+
+		// Opens every file of the batch, and when asked for finds
+		// their sizes at the same time
+		void openFiles(int flags, bool findSizes)
+		{
+			unsigned count = 0;
+
+			for(std::size_t index = 0; index < this->files.size(); ++index)
+			{
+				io_uring_sqe * const openEntry = this->ring.getSubmission();
+				openEntry->opcode = IORING_OP_OPENAT;
+				openEntry->fd = AT_FDCWD;
+				openEntry->addr = reinterpret_cast<std::uintptr_t>(this->files[index].path);
+				openEntry->open_flags = static_cast<std::uint32_t>(flags | O_CLOEXEC);
+				openEntry->len = 0666;
+				openEntry->user_data = (index * 2);
+				++count;
+
+				if(!findSizes)
+					continue;
+
+				io_uring_sqe * const statusEntry = this->ring.getSubmission();
+				statusEntry->opcode = IORING_OP_STATX;
+				statusEntry->fd = AT_FDCWD;
+				statusEntry->addr = reinterpret_cast<std::uintptr_t>(this->files[index].path);
+				statusEntry->len = STATX_SIZE;
+				statusEntry->off = reinterpret_cast<std::uintptr_t>(&this->statuses[index]);
+				statusEntry->user_data = ((index * 2) + 1);
+				++count;
+			}
+
+			this->complete(count, [this](const io_uring_cqe & completion)
+			{
+				BatchFile & file = this->files[completion.user_data / 2];
+
+				if(completion.res < 0)
+					file.isFailed = true;
+				else if((completion.user_data % 2) == 0)
+					file.descriptor = completion.res;
+			});
+		}
+
+		// Reads or writes the rest of every file that's still open,
+		// going round again for any that were moved short
+		void transferFiles(std::uint8_t operation)
+		{
+			// Kept below 2 GiB, the most one read or write will move
+			const std::size_t maximumTransferSize = (1u << 30);
+
+			while(!this->isBroken)
+			{
+				unsigned count = 0;
+
+				for(std::size_t index = 0; index < this->files.size(); ++index)
+				{
+					const BatchFile & file = this->files[index];
+
+					if(file.isFailed || (file.descriptor < 0) || (file.offset >= file.size))
+						continue;
+
+					io_uring_sqe * const transferEntry = this->ring.getSubmission();
+					transferEntry->opcode = operation;
+					transferEntry->fd = file.descriptor;
+					transferEntry->addr = reinterpret_cast<std::uintptr_t>(file.buffer + file.offset);
+					transferEntry->len = static_cast<std::uint32_t>((std::min)(maximumTransferSize, (file.size - file.offset)));
+					transferEntry->off = file.offset;
+					transferEntry->user_data = index;
+					++count;
+				}
+
+				if(count == 0)
+					return;
+
+				this->complete(count, [this, operation](const io_uring_cqe & completion)
+				{
+					BatchFile & file = this->files[completion.user_data];
+
+					if(completion.res > 0)
+						file.offset += static_cast<std::size_t>(completion.res);
+					else if((completion.res == 0) && (operation == IORING_OP_READ))
+						file.size = file.offset;
+					else if((completion.res != -EINTR) && (completion.res != -EAGAIN))
+						file.isFailed = true;
+				});
+			}
+		}
+
+		// A close that fails can mean a write that never made it
+		void closeFiles()
+		{
+			if(this->isBroken)
+			{
+				for(auto & file : this->files)
+					if(file.descriptor >= 0)
+					{
+						::close(file.descriptor);
+						file.descriptor = -1;
+					}
+
+				return;
+			}
+
+			unsigned count = 0;
+
+			for(std::size_t index = 0; index < this->files.size(); ++index)
+			{
+				if(this->files[index].descriptor < 0)
+					continue;
+
+				io_uring_sqe * const closeEntry = this->ring.getSubmission();
+				closeEntry->opcode = IORING_OP_CLOSE;
+				closeEntry->fd = this->files[index].descriptor;
+				closeEntry->user_data = index;
+				++count;
+			}
+
+			if(count == 0)
+				return;
+
+			this->complete(count, [this](const io_uring_cqe & completion)
+			{
+				BatchFile & file = this->files[completion.user_data];
+
+				file.descriptor = -1;
+
+				if(completion.res < 0)
+					file.isFailed = true;
+			});
+
+			// Whatever didn't get closed through the ring
+			if(this->isBroken)
+				this->closeFiles();
+		}
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Script.h"
+#include "Analysis\JumpTable.h"
+#include "Analysis\VariableResolution.h"
+
+namespace VNVita
+{
+	// Every loaded script of a novel, the jump table that links them
+	// and the variable slots they share
+	class Novel
+	{
+	private:
+		std::vector<Script> scripts;
+		JumpTable jumps;
+		VariableResolution variables;
+
+	public:
+		Novel() = default;
+
+		Novel(const std::vector<Script> & scripts) :
+			scripts(scripts), jumps(this->scripts), variables(this->scripts)
+		{
+		}
+
+		Novel(std::vector<Script> && scripts) :
+			scripts(std::move(scripts)), jumps(this->scripts), variables(this->scripts)
+		{
+		}
+
+		const std::vector<Script> & getScripts() const
+		{
+			return this->scripts;
+		}
+
+		std::size_t size() const
+		{
+			return this->scripts.size();
+		}
+
+		const Script & getScript(std::size_t index) const
+		{
+			return this->scripts[index];
+		}
+
+		const JumpTable & getJumps() const
+		{
+			return this->jumps;
+		}
+
+		const VariableResolution & getVariables() const
+		{
+			return this->variables;
+		}
+
+		bool tryGetScriptIndex(const std::string & path, std::size_t & scriptIndex) const
+		{
+			return this->jumps.tryGetScriptIndex(path, scriptIndex);
+		}
+	};
+}
\ No newline at end of file
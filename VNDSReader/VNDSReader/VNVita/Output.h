@@ -0,0 +1 @@
+#include "Output\Output.h"
\ No newline at end of file
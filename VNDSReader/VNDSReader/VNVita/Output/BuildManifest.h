@@ -0,0 +1,142 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace VNVita
+{
+	struct BuildRecord
+	{
+		std::uint64_t inputHash;
+		std::uint64_t outputHash;
+
+		// Whatever the caller uses to tell apart options that change the output
+		std::string settings;
+	};
+
+	// What each input file last converted to: the hash of its content,
+	// the settings it was converted with and the hash of what was written.
+	// With it a later run can leave unchanged files and their outputs alone.
+	//
+	// Stored as text, one input per line after a header,
+	// with the path last so it may hold spaces:
+	//
+	//   vnvita-build 1
+	//   <input hash> <output hash> <settings> <path>
+	class BuildManifest
+	{
+	public:
+		static constexpr const char * header = "vnvita-build 1";
+
+	private:
+		static constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ull;
+		static constexpr std::uint64_t fnvPrime = 1099511628211ull;
+
+	private:
+		// Ordered so the file is written the same way every time
+		std::map<std::string, BuildRecord> records;
+
+	public:
+		// FNV-1a, stable across platforms and runs
+		static std::uint64_t hash(const std::string & bytes)
+		{
+			std::uint64_t hash = fnvOffsetBasis;
+
+			for(const char c : bytes)
+			{
+				hash ^= static_cast<unsigned char>(c);
+				hash *= fnvPrime;
+			}
+
+			return hash;
+		}
+
+		std::size_t size() const
+		{
+			return this->records.size();
+		}
+
+		const BuildRecord * tryGetRecord(const std::string & inputPath) const
+		{
+			const auto iterator = this->records.find(inputPath);
+			return (iterator != this->records.end()) ? &iterator->second : nullptr;
+		}
+
+		void setRecord(const std::string & inputPath, const BuildRecord & record)
+		{
+			this->records[inputPath] = record;
+		}
+
+		// A missing file loads as an empty manifest,
+		// anything that isn't a manifest fails to load
+		bool tryLoad(const std::string & path)
+		{
+			this->records.clear();
+
+			std::ifstream file(path);
+			if(!file)
+				return true;
+
+			std::string line;
+			if(!std::getline(file, line) || (line != header))
+				return false;
+
+			while(std::getline(file, line))
+			{
+				if(line.empty())
+					continue;
+
+				std::istringstream stream(line);
+				BuildRecord record;
+				std::string inputPath;
+
+				stream >> std::hex >> record.inputHash >> record.outputHash >> record.settings;
+
+				if(!stream || (stream.get() != ' ') || !std::getline(stream, inputPath) || inputPath.empty())
+				{
+					this->records.clear();
+					return false;
+				}
+
+				this->records[inputPath] = record;
+			}
+
+			return true;
+		}
+
+		bool trySave(const std::string & path) const
+		{
+			std::ofstream file(path);
+
+			file << header << '\n';
+
+			for(const auto & entry : this->records)
+			{
+				const BuildRecord & record = entry.second;
+				file << std::hex << record.inputHash << ' ' << record.outputHash << ' ' << record.settings << ' ' << entry.first << '\n';
+			}
+
+			return static_cast<bool>(file);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "OutputBuffer.h"
+#include "OutputFormat.h"
+#include "BuildManifest.h"
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace VNVita
+{
+	// Gathers output in a fixed block of memory and hands it
+	// to the stream a block at a time, instead of once per token.
+	// Whatever is left is written when the buffer is destroyed.
+	class OutputBuffer
+	{
+	public:
+		static constexpr std::size_t defaultCapacity = (256 * 1024);
+
+	private:
+		std::ostream & outputStream;
+		std::vector<char> buffer;
+		std::size_t size = 0;
+
+	public:
+		OutputBuffer(std::ostream & outputStream, std::size_t capacity = defaultCapacity) :
+			outputStream(outputStream), buffer((capacity > 0) ? capacity : 1)
+		{
+		}
+
+		OutputBuffer(const OutputBuffer &) = delete;
+		OutputBuffer & operator =(const OutputBuffer &) = delete;
+
+		~OutputBuffer()
+		{
+			this->flush();
+		}
+
+		void write(char c)
+		{
+			if(this->size == this->buffer.size())
+				this->flush();
+
+			this->buffer[this->size] = c;
+			++this->size;
+		}
+
+		void write(const char * data, std::size_t length)
+		{
+			if(length > (this->buffer.size() - this->size))
+			{
+				this->flush();
+
+				// Too big to be worth copying
+				if(length > this->buffer.size())
+				{
+					this->outputStream.write(data, static_cast<std::streamsize>(length));
+					return;
+				}
+			}
+
+			std::memcpy(this->buffer.data() + this->size, data, length);
+			this->size += length;
+		}
+
+		void write(const char * text)
+		{
+			this->write(text, std::strlen(text));
+		}
+
+		void write(const std::string & text)
+		{
+			this->write(text.data(), text.size());
+		}
+
+		// Always in the classic locale's format: an optional '-' and the digits
+		void write(int value)
+		{
+			// Enough for the digits of any 64 bit value and a sign
+			char digits[24];
+			char * first = (digits + sizeof(digits));
+
+			// Negated as unsigned so the most negative value doesn't overflow
+			unsigned long long magnitude = (value < 0) ? (0ull - static_cast<unsigned long long>(value)) : static_cast<unsigned long long>(value);
+
+			do
+			{
+				--first;
+				*first = static_cast<char>('0' + (magnitude % 10));
+				magnitude /= 10;
+			}
+			while(magnitude > 0);
+
+			if(value < 0)
+			{
+				--first;
+				*first = '-';
+			}
+
+			this->write(first, static_cast<std::size_t>((digits + sizeof(digits)) - first));
+		}
+
+		void flush()
+		{
+			if(this->size == 0)
+				return;
+
+			this->outputStream.write(this->buffer.data(), static_cast<std::streamsize>(this->size));
+			this->size = 0;
+		}
+	};
+}
\ No newline at end of file
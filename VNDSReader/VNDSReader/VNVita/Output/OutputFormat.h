@@ -0,0 +1,112 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "../Commands.h"
+#include "../Visitors/CommandBinaryVisitor.h"
+#include "../Visitors/CommandFormatVisitor.h"
+#include "../Visitors/CommandJsonLinesVisitor.h"
+
+namespace VNVita
+{
+	enum class OutputFormat : std::uint8_t
+	{
+		VNVita,
+		JsonLines,
+		Binary,
+	};
+
+	// Accepts the names used on the command line: vnvita, jsonl and binary
+	inline bool tryParseOutputFormat(const std::string & name, OutputFormat & format)
+	{
+		if(name == "vnvita")
+		{
+			format = OutputFormat::VNVita;
+			return true;
+		}
+
+		if(name == "jsonl")
+		{
+			format = OutputFormat::JsonLines;
+			return true;
+		}
+
+		if(name == "binary")
+		{
+			format = OutputFormat::Binary;
+			return true;
+		}
+
+		return false;
+	}
+
+	inline const char * getOutputFormatName(OutputFormat format)
+	{
+		switch(format)
+		{
+		case OutputFormat::VNVita:
+			return "vnvita";
+		case OutputFormat::JsonLines:
+			return "jsonl";
+		case OutputFormat::Binary:
+			return "binary";
+		default:
+			return "";
+		}
+	}
+
+	inline const char * getOutputExtension(OutputFormat format)
+	{
+		switch(format)
+		{
+		case OutputFormat::VNVita:
+			return ".vnvita";
+		case OutputFormat::JsonLines:
+			return ".jsonl";
+		case OutputFormat::Binary:
+			return ".vnvb";
+		default:
+			return "";
+		}
+	}
+
+	// Only the binary format needs its stream opened in binary mode
+	inline bool isBinaryOutputFormat(OutputFormat format)
+	{
+		return (format == OutputFormat::Binary);
+	}
+
+	// Makes the visitor that writes the format. Each one streams a command
+	// at a time and writes whatever it has buffered when it's destroyed.
+	inline std::unique_ptr<CommandVisitor> makeOutputVisitor(OutputFormat format, std::ostream & outputStream)
+	{
+		switch(format)
+		{
+		case OutputFormat::JsonLines:
+			return std::make_unique<CommandJsonLinesVisitor>(outputStream);
+		case OutputFormat::Binary:
+			return std::make_unique<CommandBinaryVisitor>(outputStream);
+		default:
+			return std::make_unique<CommandFormatVisitor>(outputStream);
+		}
+	}
+}
\ No newline at end of file
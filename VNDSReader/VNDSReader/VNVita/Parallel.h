@@ -0,0 +1,71 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace VNVita
+{
+	// A thread count of 0 means one per hardware thread
+	inline std::size_t getThreadCount(std::size_t threadCount)
+	{
+		if(threadCount > 0)
+			return threadCount;
+
+		return (std::max)(static_cast<std::size_t>(std::thread::hardware_concurrency()), static_cast<std::size_t>(1));
+	}
+
+	// Calls worker(threadIndex) on threadCount threads, the calling
+	// thread being index 0, and returns once every call has
+	template<typename Worker>
+	void runOnThreads(std::size_t threadCount, Worker worker)
+	{
+		std::vector<std::thread> threads;
+
+		if(threadCount > 1)
+			threads.reserve(threadCount - 1);
+
+		for(std::size_t index = 1; index < threadCount; ++index)
+			threads.emplace_back(worker, index);
+
+		worker(0);
+
+		for(auto & thread : threads)
+			thread.join();
+	}
+
+	// Calls function(index) for every index below count, spread over
+	// up to threadCount threads. Indices are handed out one at a time,
+	// so work of uneven size still keeps every thread busy.
+	template<typename Function>
+	void forEachInParallel(std::size_t count, std::size_t threadCount, Function function)
+	{
+		std::atomic<std::size_t> nextIndex(0);
+
+		runOnThreads((std::min)(getThreadCount(threadCount), count), [&nextIndex, count, &function](std::size_t threadIndex)
+		{
+			static_cast<void>(threadIndex);
+
+			for(std::size_t index = nextIndex++; index < count; index = nextIndex++)
+				function(index);
+		});
+	}
+}
\ No newline at end of file
@@ -0,0 +1 @@
+#include "Passes\Passes.h"
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../Commands.h"
+
+namespace VNVita
+{
+	using CommandList = std::vector<std::shared_ptr<Command>>;
+
+	// Shared by the passes: drops the commands whose flag is set
+	// in one stable sweep and returns how many were dropped
+	inline std::size_t removeFlagged(CommandList & commands, const std::vector<bool> & isRemoved)
+	{
+		std::size_t kept = 0;
+
+		for(std::size_t index = 0; index < commands.size(); ++index)
+			if(!isRemoved[index])
+			{
+				if(kept != index)
+					commands[kept] = std::move(commands[index]);
+
+				++kept;
+			}
+
+		const std::size_t removedCount = (commands.size() - kept);
+		commands.resize(kept);
+		return removedCount;
+	}
+}
\ No newline at end of file
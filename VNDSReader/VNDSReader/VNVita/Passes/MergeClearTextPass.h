@@ -0,0 +1,46 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <vector>
+
+#include "../Commands.h"
+#include "CommandPass.h"
+
+namespace VNVita
+{
+	// A cleartext straight after another one has nothing left to clear
+	class MergeClearTextPass
+	{
+	public:
+		static const char * getName()
+		{
+			return "merge-cleartext";
+		}
+
+		static std::size_t run(CommandList & commands)
+		{
+			std::vector<bool> isRemoved(commands.size(), false);
+
+			for(std::size_t index = 1; index < commands.size(); ++index)
+				isRemoved[index] = isa<ClearTextCommand>(*commands[index]) && isa<ClearTextCommand>(*commands[index - 1]);
+
+			return removeFlagged(commands, isRemoved);
+		}
+	};
+}
\ No newline at end of file
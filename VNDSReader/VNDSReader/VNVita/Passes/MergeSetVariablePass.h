@@ -0,0 +1,149 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Commands.h"
+#include "CommandPass.h"
+
+namespace VNVita
+{
+	// Folds a run of setvar x + n (or x - n) on the same variable
+	// into one command.
+	//
+	// Only valid if the variable holds an int: for a string
+	// setvar x + 1 twice appends "11", not "2".
+	class MergeSetVariablePass
+	{
+	public:
+		static const char * getName()
+		{
+			return "merge-setvar";
+		}
+
+		static std::size_t run(CommandList & commands)
+		{
+			std::vector<bool> isRemoved(commands.size(), false);
+
+			std::size_t index = 0;
+
+			while(index < commands.size())
+			{
+				int total;
+				if(!tryGetStep(*commands[index], total))
+				{
+					++index;
+					continue;
+				}
+
+				const auto & first = cast<SetLocalVariableCommand>(*commands[index]);
+
+				std::size_t end = (index + 1);
+
+				for(int step; (end < commands.size()) && tryGetStep(*commands[end], step); ++end)
+				{
+					const auto & next = cast<SetLocalVariableCommand>(*commands[end]);
+
+					if((next.getLeft() != first.getLeft()) || (next.getOperation() != first.getOperation()))
+						break;
+
+					// A total that doesn't fit in an int can't be written as one step
+					if(!canAdd(total, step))
+						break;
+
+					total += step;
+					isRemoved[end] = true;
+				}
+
+				if(end > (index + 1))
+				{
+					// Keep the operand's original leading whitespace
+					const std::string & right = first.getRight();
+					const std::string prefix = right.substr(0, right.find_first_not_of(" \t"));
+
+					commands[index] = std::make_shared<SetLocalVariableCommand>(first.getLeft(), first.getOperation(), prefix + std::to_string(total));
+				}
+
+				index = end;
+			}
+
+			return removeFlagged(commands, isRemoved);
+		}
+
+	private:
+		static bool canAdd(int left, int right)
+		{
+			if(right > 0)
+				return (left <= ((std::numeric_limits<int>::max)() - right));
+
+			return (left >= ((std::numeric_limits<int>::min)() - right));
+		}
+
+		// True for setvar x + n and setvar x - n with an int n
+		static bool tryGetStep(const Command & command, int & step)
+		{
+			const auto setCommand = tryCast<SetLocalVariableCommand>(&command);
+
+			if((setCommand == nullptr) || ((setCommand->getOperation() != SetOperation::Add) && (setCommand->getOperation() != SetOperation::Subtract)))
+				return false;
+
+			const std::string & right = setCommand->getRight();
+
+			const auto first = right.find_first_not_of(" \t\r");
+			if(first == std::string::npos)
+				return false;
+
+			const auto last = right.find_last_not_of(" \t\r");
+
+			std::size_t index = first;
+			if((right[index] == '-') || (right[index] == '+'))
+				++index;
+
+			if(index > last)
+				return false;
+
+			const bool isNegative = (right[first] == '-');
+
+			// Built up as a negative number, which reaches one further than a positive one
+			const int limit = isNegative ? (std::numeric_limits<int>::min)() : -(std::numeric_limits<int>::max)();
+
+			int value = 0;
+
+			for(; index <= last; ++index)
+			{
+				if((right[index] < '0') || (right[index] > '9'))
+					return false;
+
+				const int digit = (right[index] - '0');
+
+				// Too long for an int, leave it as it is
+				if(value < ((limit + digit) / 10))
+					return false;
+
+				value = ((value * 10) - digit);
+			}
+
+			step = isNegative ? value : -value;
+			return true;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <vector>
+
+#include "../Commands.h"
+#include "CommandPass.h"
+#include "RemoveSkipsPass.h"
+#include "RemoveDeadCodePass.h"
+#include "MergeClearTextPass.h"
+#include "RemoveOverriddenBackgroundsPass.h"
+#include "MergeSetVariablePass.h"
+
+namespace VNVita
+{
+	struct PassReport
+	{
+		const char * name;
+		std::size_t removedCount;
+	};
+
+	// Shrinks a filtered command list before it's formatted.
+	//
+	// Level 1 only makes changes that can't be observed: comments,
+	// unreachable code, repeated cleartext and backgrounds replaced
+	// before they're shown. Level 2 also merges setvar runs, which
+	// assumes the variables involved hold ints.
+	class PassPipeline
+	{
+	private:
+		int level;
+
+	public:
+		PassPipeline(int level) :
+			level(level)
+		{
+		}
+
+		int getLevel() const
+		{
+			return this->level;
+		}
+
+		std::vector<PassReport> run(CommandList & commands) const
+		{
+			std::vector<PassReport> reports;
+
+			if(this->level < 1)
+				return reports;
+
+			// Skips go first so the other passes see adjacent commands
+			runPass<RemoveSkipsPass>(commands, reports);
+			runPass<RemoveDeadCodePass>(commands, reports);
+			runPass<MergeClearTextPass>(commands, reports);
+			runPass<RemoveOverriddenBackgroundsPass>(commands, reports);
+
+			if(this->level < 2)
+				return reports;
+
+			runPass<MergeSetVariablePass>(commands, reports);
+
+			return reports;
+		}
+
+	private:
+		template<typename Pass>
+		static void runPass(CommandList & commands, std::vector<PassReport> & reports)
+		{
+			reports.push_back(PassReport { Pass::getName(), Pass::run(commands) });
+		}
+	};
+}
\ No newline at end of file
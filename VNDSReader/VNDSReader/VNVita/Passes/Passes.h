@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../Commands.h"
+
+#include "CommandPass.h"
+#include "RemoveSkipsPass.h"
+#include "RemoveDeadCodePass.h"
+#include "MergeClearTextPass.h"
+#include "RemoveOverriddenBackgroundsPass.h"
+#include "MergeSetVariablePass.h"
+#include "PassPipeline.h"
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Analysis/IfBlockTable.h"
+#include "../Analysis/LabelIndex.h"
+#include "../Analysis/ControlFlowGraph.h"
+#include "CommandPass.h"
+
+namespace VNVita
+{
+	// Code after an endscript, goto or jump that no goto reaches.
+	//
+	// Any label may be the target of a jump from another script,
+	// so every block starting with one is kept alive. An if and its
+	// fi are only removed together, so the blocks that are left
+	// still pair up.
+	class RemoveDeadCodePass
+	{
+	public:
+		static const char * getName()
+		{
+			return "remove-dead-code";
+		}
+
+		static std::size_t run(CommandList & commands)
+		{
+			const IfBlockTable ifBlocks(commands);
+			const LabelIndex labels(commands);
+			const ControlFlowGraph flowGraph(commands, ifBlocks, labels);
+
+			std::vector<bool> isLive(flowGraph.size(), false);
+			std::vector<std::size_t> pending;
+
+			for(std::size_t blockIndex = 0; blockIndex < flowGraph.size(); ++blockIndex)
+			{
+				const BasicBlock & block = flowGraph.getBlock(blockIndex);
+
+				if((blockIndex == 0) || isa<LabelCommand>(*commands[block.first]))
+				{
+					isLive[blockIndex] = true;
+					pending.push_back(blockIndex);
+				}
+			}
+
+			while(!pending.empty())
+			{
+				const std::size_t blockIndex = pending.back();
+				pending.pop_back();
+
+				for(const std::size_t successor : flowGraph.getBlock(blockIndex).successors)
+					if(!isLive[successor])
+					{
+						isLive[successor] = true;
+						pending.push_back(successor);
+					}
+			}
+
+			std::vector<bool> isRemoved(commands.size(), false);
+
+			for(std::size_t index = 0; index < commands.size(); ++index)
+				isRemoved[index] = !isLive[flowGraph.getBlockIndex(index)];
+
+			for(std::size_t index = 0; index < commands.size(); ++index)
+			{
+				std::size_t fiIndex;
+				if(!isa<IfCommand>(*commands[index]) || !ifBlocks.tryGetMatchingFi(index, fiIndex))
+					continue;
+
+				if(isRemoved[index] != isRemoved[fiIndex])
+				{
+					isRemoved[index] = false;
+					isRemoved[fiIndex] = false;
+				}
+			}
+
+			return removeFlagged(commands, isRemoved);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <vector>
+
+#include "../Commands.h"
+#include "CommandPass.h"
+
+namespace VNVita
+{
+	// A bgload straight after another one replaces it before it
+	// can be seen, so the first one only costs a load.
+	//
+	// Only when neither fades: a fade takes time on screen, and the
+	// second background fades from the first. No fade time given means
+	// the default fade, so both have to say 0.
+	class RemoveOverriddenBackgroundsPass
+	{
+	public:
+		static const char * getName()
+		{
+			return "remove-overridden-backgrounds";
+		}
+
+		static std::size_t run(CommandList & commands)
+		{
+			std::vector<bool> isRemoved(commands.size(), false);
+
+			for(std::size_t index = 0; (index + 1) < commands.size(); ++index)
+				isRemoved[index] = isInstant(*commands[index]) && isInstant(*commands[index + 1]);
+
+			return removeFlagged(commands, isRemoved);
+		}
+
+	private:
+		static bool isInstant(const Command & command)
+		{
+			const auto backgroundLoadCommand = tryCast<BackgroundLoadCommand>(&command);
+			return (backgroundLoadCommand != nullptr) && (backgroundLoadCommand->getFadeTime() == 0);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1 @@
+#include "Runtime\Runtime.h"
\ No newline at end of file
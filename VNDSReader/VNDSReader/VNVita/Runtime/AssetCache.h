@@ -0,0 +1,390 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../Analysis/Asset.h"
+#include "../Analysis/PrefetchPlan.h"
+#include "RuntimeState.h"
+
+namespace VNVita
+{
+	using AssetData = std::shared_ptr<const std::vector<char>>;
+
+	struct AssetCacheCounters
+	{
+		// get found the asset loaded
+		std::uint64_t hits = 0;
+
+		// get had to load an asset nobody asked for
+		std::uint64_t misses = 0;
+
+		// get had to wait for a prefetch still in flight
+		std::uint64_t stalls = 0;
+
+		std::uint64_t loads = 0;
+		std::uint64_t failures = 0;
+		std::uint64_t evictions = 0;
+	};
+
+	// Holds the bytes of asset files under a byte budget.
+	//
+	// prefetch queues a file for a background I/O thread and get returns
+	// it, loading it on the calling thread if nobody asked for it first.
+	// Once over budget the least recently used files are dropped, except
+	// those in use by the pinned scene and those still loading.
+	// Returned data stays valid while it's held, even after eviction.
+	// A file that couldn't be read isn't kept, the next get tries again.
+	class AssetCache
+	{
+	public:
+		static constexpr std::size_t defaultByteBudget = (32 * 1024 * 1024);
+
+	private:
+		enum class EntryState : std::uint8_t
+		{
+			Queued,
+			Loading,
+			Loaded,
+		};
+
+		struct Entry
+		{
+			EntryState state = EntryState::Queued;
+			AssetData data;
+			std::size_t size = 0;
+			bool isPinned = false;
+
+			// Position in the recency list, only valid once loaded
+			std::list<std::string>::iterator recency;
+		};
+
+	private:
+		std::string rootPath;
+		std::size_t byteBudget;
+
+		std::mutex mutex;
+		std::condition_variable loaded;
+		std::condition_variable queued;
+
+		std::unordered_map<std::string, Entry> entries;
+
+		// Most recently used at the front
+		std::list<std::string> recency;
+
+		std::deque<std::string> queue;
+		std::unordered_set<std::string> pinned;
+		std::size_t byteCount = 0;
+		AssetCacheCounters counters;
+
+		bool isStopping = false;
+		std::thread loader;
+
+	public:
+		// rootPath is the novel's directory, with a trailing separator
+		AssetCache(const std::string & rootPath, std::size_t byteBudget = defaultByteBudget) :
+			rootPath(rootPath), byteBudget(byteBudget)
+		{
+			this->loader = std::thread([this]()
+			{
+				this->runLoader();
+			});
+		}
+
+		AssetCache(const AssetCache &) = delete;
+		AssetCache & operator =(const AssetCache &) = delete;
+
+		~AssetCache()
+		{
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->isStopping = true;
+			}
+
+			this->queued.notify_all();
+			this->loader.join();
+		}
+
+		std::size_t getByteBudget()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			return this->byteBudget;
+		}
+
+		void setByteBudget(std::size_t byteBudget)
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->byteBudget = byteBudget;
+			this->trim();
+		}
+
+		std::size_t getByteCount()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			return this->byteCount;
+		}
+
+		AssetCacheCounters getCounters()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			return this->counters;
+		}
+
+		// Queues the file for the I/O thread unless it's loaded or on its way
+		void prefetch(AssetType type, const std::string & path)
+		{
+			std::string key = makeKey(type, path);
+
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+
+				if(!this->entries.emplace(key, Entry()).second)
+					return;
+
+				this->queue.push_back(std::move(key));
+			}
+
+			this->queued.notify_one();
+		}
+
+		// Queues everything PrefetchPlan::getPrefetchSet returned, nearest first
+		void prefetch(const PrefetchPlan & plan, AssetRange range)
+		{
+			for(const std::uint32_t id : range)
+			{
+				const Asset & asset = plan.getAsset(id);
+				this->prefetch(asset.type, asset.path);
+			}
+		}
+
+		// Returns nullptr if the file couldn't be read
+		AssetData get(AssetType type, const std::string & path)
+		{
+			const std::string key = makeKey(type, path);
+
+			std::unique_lock<std::mutex> lock(this->mutex);
+
+			auto iterator = this->entries.find(key);
+
+			if(iterator == this->entries.end())
+			{
+				++this->counters.misses;
+			}
+			else if((iterator->second.state == EntryState::Queued) || (iterator->second.state == EntryState::Loading))
+			{
+				++this->counters.stalls;
+
+				// Jump the queue rather than wait behind other prefetches
+				if(iterator->second.state == EntryState::Queued)
+				{
+					for(auto queueIterator = this->queue.begin(); queueIterator != this->queue.end(); ++queueIterator)
+						if(*queueIterator == key)
+						{
+							this->queue.erase(queueIterator);
+							break;
+						}
+
+					this->queue.push_front(key);
+				}
+
+				this->loaded.wait(lock, [this, &key, &iterator]()
+				{
+					iterator = this->entries.find(key);
+					return ((iterator == this->entries.end()) || (iterator->second.state == EntryState::Loaded));
+				});
+			}
+			else
+			{
+				++this->counters.hits;
+			}
+
+			if(iterator != this->entries.end())
+			{
+				Entry & entry = iterator->second;
+
+				if(entry.state == EntryState::Loaded)
+					this->recency.splice(this->recency.begin(), this->recency, entry.recency);
+
+				return entry.data;
+			}
+
+			// Never asked for, failed to load or dropped again
+			// before the waiting thread woke up
+			this->entries[key].state = EntryState::Loading;
+
+			lock.unlock();
+			AssetData data = this->readFile(type, path);
+			lock.lock();
+
+			AssetData result = data;
+			this->finishLoad(key, std::move(data));
+			return result;
+		}
+
+		// Keeps the scene's background, images and music loaded,
+		// releasing whatever the previous scene pinned
+		void pinScene(const SceneState & scene)
+		{
+			std::unordered_set<std::string> keys;
+
+			if(!scene.background.empty())
+				keys.insert(makeKey(AssetType::Background, scene.background));
+
+			for(const auto & image : scene.images)
+				keys.insert(makeKey(AssetType::Foreground, image.path));
+
+			if(!scene.music.empty())
+				keys.insert(makeKey(AssetType::Music, scene.music));
+
+			std::lock_guard<std::mutex> lock(this->mutex);
+
+			for(const auto & key : this->pinned)
+			{
+				const auto iterator = this->entries.find(key);
+				if(iterator != this->entries.end())
+					iterator->second.isPinned = false;
+			}
+
+			for(const auto & key : keys)
+			{
+				const auto iterator = this->entries.find(key);
+				if(iterator != this->entries.end())
+					iterator->second.isPinned = true;
+			}
+
+			this->pinned = std::move(keys);
+			this->trim();
+		}
+
+	private:
+		static std::string makeKey(AssetType type, const std::string & path)
+		{
+			return (static_cast<char>(type) + path);
+		}
+
+		AssetData readFile(AssetType type, const std::string & path) const
+		{
+			std::ifstream file(this->rootPath + getAssetDirectory(type) + path, std::ios::binary);
+
+			if(!file)
+				return nullptr;
+
+			auto data = std::make_shared<std::vector<char>>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			if(file.bad())
+				return nullptr;
+
+			return data;
+		}
+
+		void runLoader()
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+
+			while(true)
+			{
+				this->queued.wait(lock, [this]()
+				{
+					return (this->isStopping || !this->queue.empty());
+				});
+
+				if(this->isStopping)
+					return;
+
+				const std::string key = std::move(this->queue.front());
+				this->queue.pop_front();
+
+				this->entries[key].state = EntryState::Loading;
+
+				lock.unlock();
+				AssetData data = this->readFile(static_cast<AssetType>(key[0]), key.substr(1));
+				lock.lock();
+
+				this->finishLoad(key, std::move(data));
+			}
+		}
+
+		// Called with the mutex held
+		void finishLoad(const std::string & key, AssetData && data)
+		{
+			if(data == nullptr)
+			{
+				// Dropped so a later get or prefetch tries again
+				this->entries.erase(key);
+				++this->counters.failures;
+			}
+			else
+			{
+				Entry & entry = this->entries[key];
+
+				entry.state = EntryState::Loaded;
+				entry.size = data->size();
+				entry.data = std::move(data);
+				entry.isPinned = (this->pinned.count(key) != 0);
+
+				this->recency.push_front(key);
+				entry.recency = this->recency.begin();
+
+				this->byteCount += entry.size;
+				++this->counters.loads;
+			}
+
+			this->loaded.notify_all();
+			this->trim();
+		}
+
+		// Called with the mutex held
+		void trim()
+		{
+			auto iterator = this->recency.end();
+
+			while((this->byteCount > this->byteBudget) && (iterator != this->recency.begin()))
+			{
+				--iterator;
+
+				// The asset just used or loaded is always kept
+				if(iterator == this->recency.begin())
+					break;
+
+				const auto entryIterator = this->entries.find(*iterator);
+				if(entryIterator->second.isPinned)
+					continue;
+
+				this->byteCount -= entryIterator->second.size;
+				++this->counters.evictions;
+
+				this->entries.erase(entryIterator);
+				iterator = this->recency.erase(iterator);
+			}
+		}
+	};
+}
\ No newline at end of file
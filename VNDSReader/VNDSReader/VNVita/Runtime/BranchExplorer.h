@@ -0,0 +1,531 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Novel.h"
+#include "../Parallel.h"
+#include "RuntimeState.h"
+#include "ScriptEventHandler.h"
+#include "ScriptEngine.h"
+#include "VariableStore.h"
+#include "VariableValue.h"
+
+namespace VNVita
+{
+	enum class DecisionType : std::uint8_t
+	{
+		// value is the 0-based option
+		Choice,
+
+		// value is the number drawn
+		Random,
+	};
+
+	struct Decision
+	{
+		DecisionType type;
+		int value;
+	};
+
+	enum class ReachTargetType : std::uint8_t
+	{
+		Label,
+		EndScript,
+	};
+
+	// A label or endscript and the shortest list of decisions that reaches it
+	struct ReachTarget
+	{
+		ReachTargetType type;
+		std::size_t scriptIndex;
+		std::size_t commandIndex;
+		bool isReachable;
+		std::vector<Decision> path;
+	};
+
+	struct ExplorationOptions
+	{
+		std::size_t scriptIndex = 0;
+
+		// 0 uses every core
+		std::size_t threadCount = 0;
+
+		// Between two decisions, stops scripts that loop forever
+		std::uint64_t maximumCommands = 1000000;
+
+		// Stops exploring past this many distinct states
+		std::size_t maximumStates = 10000000;
+	};
+
+	struct ExplorationResult
+	{
+		std::vector<ReachTarget> targets;
+		std::size_t stateCount = 0;
+		std::size_t faultedCount = 0;
+		std::size_t unfinishedCount = 0;
+		bool isComplete = true;
+	};
+
+	// Forks execution at every choice option and every random outcome,
+	// breadth first so the first path to reach a target is a shortest one.
+	//
+	// States are only compared where a decision is made, since everything
+	// between two decisions is deterministic. A state is identified by a
+	// 64-bit hash of script, program counter and variables; the scene
+	// can't change control flow so it's left out.
+	//
+	// Each level of the search is split over worker threads that each own
+	// a deque, take work from its back and steal from the front of others.
+	class BranchExplorer
+	{
+	private:
+		static constexpr std::size_t shardCount = 64;
+		static constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ull;
+		static constexpr std::uint64_t fnvPrime = 1099511628211ull;
+
+		// Decisions are shared with every path that extends them
+		struct PathNode
+		{
+			std::shared_ptr<const PathNode> parent;
+			Decision decision;
+		};
+
+		using Path = std::shared_ptr<const PathNode>;
+
+		struct Node
+		{
+			RuntimeState state;
+			Path path;
+		};
+
+		struct Shard
+		{
+			std::mutex mutex;
+			std::unordered_set<std::uint64_t> hashes;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Node> nodes;
+		};
+
+		// Everything one worker found while running one level
+		struct WorkerOutput
+		{
+			std::vector<Node> next;
+			std::vector<std::pair<std::size_t, Path>> reached;
+			std::size_t faultedCount = 0;
+			std::size_t unfinishedCount = 0;
+
+			// New states, added to stateCount once the level is done
+			std::size_t visitedCount = 0;
+		};
+
+		// Records which targets a segment of execution passes
+		class TargetRecorder : public ScriptEventHandler
+		{
+		private:
+			const BranchExplorer & explorer;
+			const ScriptEngine * engine = nullptr;
+			std::vector<std::size_t> reached;
+
+		public:
+			TargetRecorder(const BranchExplorer & explorer) :
+				explorer(explorer)
+			{
+			}
+
+			void setEngine(const ScriptEngine & engine)
+			{
+				this->engine = &engine;
+			}
+
+			std::vector<std::size_t> & getReached()
+			{
+				return this->reached;
+			}
+
+			void onLabel(const LabelCommand & labelCommand) override
+			{
+				static_cast<void>(labelCommand);
+
+				std::size_t target;
+				if(this->explorer.tryGetTarget(this->engine->getScriptIndex(), this->engine->getProgramCounter() - 1, target))
+					this->reached.push_back(target);
+			}
+		};
+
+	private:
+		const Novel & novel;
+		ExplorationOptions options;
+
+		std::vector<ReachTarget> targets;
+		std::unordered_map<std::uint64_t, std::size_t> targetIndices;
+
+		std::array<Shard, shardCount> shards;
+
+		// Only touched between levels, when no worker is running
+		std::size_t stateCount = 0;
+
+	public:
+		BranchExplorer(const Novel & novel, const ExplorationOptions & options) :
+			novel(novel), options(options)
+		{
+			for(std::size_t scriptIndex = 0; scriptIndex < novel.size(); ++scriptIndex)
+			{
+				const Script & script = novel.getScript(scriptIndex);
+
+				for(std::size_t commandIndex = 0; commandIndex < script.size(); ++commandIndex)
+				{
+					const CommandKind kind = script.getCommand(commandIndex).getKind();
+
+					if(kind == CommandKind::Label)
+						this->addTarget(ReachTargetType::Label, scriptIndex, commandIndex);
+					else if(kind == CommandKind::EndScript)
+						this->addTarget(ReachTargetType::EndScript, scriptIndex, commandIndex);
+				}
+			}
+
+			this->options.threadCount = getThreadCount(this->options.threadCount);
+		}
+
+		BranchExplorer(const BranchExplorer &) = delete;
+		BranchExplorer & operator =(const BranchExplorer &) = delete;
+
+		ExplorationResult explore()
+		{
+			ExplorationResult result;
+			std::vector<Path> paths(this->targets.size());
+
+			std::vector<Node> level;
+			level.push_back(Node { this->createStartState(), nullptr });
+
+			while(!level.empty())
+			{
+				if(this->stateCount >= this->options.maximumStates)
+				{
+					result.isComplete = false;
+					break;
+				}
+
+				std::vector<WorkerOutput> outputs = this->runLevel(std::move(level));
+				level.clear();
+
+				for(auto & output : outputs)
+				{
+					// Paths within a level are equally short, the first found is kept
+					for(auto & reached : output.reached)
+						if(!this->targets[reached.first].isReachable)
+						{
+							this->targets[reached.first].isReachable = true;
+							paths[reached.first] = std::move(reached.second);
+						}
+
+					result.faultedCount += output.faultedCount;
+					result.unfinishedCount += output.unfinishedCount;
+					this->stateCount += output.visitedCount;
+
+					for(auto & node : output.next)
+						level.push_back(std::move(node));
+				}
+			}
+
+			for(std::size_t index = 0; index < this->targets.size(); ++index)
+				this->targets[index].path = flattenPath(paths[index]);
+
+			result.targets = this->targets;
+			result.stateCount = this->stateCount;
+			return result;
+		}
+
+	private:
+		static std::uint64_t getTargetKey(std::size_t scriptIndex, std::size_t commandIndex)
+		{
+			return ((static_cast<std::uint64_t>(scriptIndex) << 32) | static_cast<std::uint64_t>(commandIndex));
+		}
+
+		void addTarget(ReachTargetType type, std::size_t scriptIndex, std::size_t commandIndex)
+		{
+			this->targetIndices.emplace(getTargetKey(scriptIndex, commandIndex), this->targets.size());
+			this->targets.push_back(ReachTarget { type, scriptIndex, commandIndex, false, std::vector<Decision>() });
+		}
+
+		bool tryGetTarget(std::size_t scriptIndex, std::size_t commandIndex, std::size_t & target) const
+		{
+			const auto iterator = this->targetIndices.find(getTargetKey(scriptIndex, commandIndex));
+
+			if(iterator == this->targetIndices.end())
+				return false;
+
+			target = iterator->second;
+			return true;
+		}
+
+		RuntimeState createStartState() const
+		{
+			ScriptEventHandler handler;
+			ScriptEngine engine(this->novel, handler);
+			engine.start(this->options.scriptIndex);
+			return engine.takeSnapshot();
+		}
+
+		std::vector<WorkerOutput> runLevel(std::vector<Node> && level)
+		{
+			const std::size_t threadCount = (std::min)(this->options.threadCount, level.size());
+
+			std::vector<WorkQueue> queues(threadCount);
+			std::vector<WorkerOutput> outputs(threadCount);
+
+			// Deal the level out round robin so every worker starts busy
+			for(std::size_t index = 0; index < level.size(); ++index)
+				queues[index % threadCount].nodes.push_back(std::move(level[index]));
+
+			const auto worker = [this, &queues, &outputs](std::size_t workerIndex)
+			{
+				TargetRecorder recorder(*this);
+				ScriptEngine engine(this->novel, recorder);
+				engine.setExternalRandom(true);
+				recorder.setEngine(engine);
+
+				Node node;
+				while(tryTakeNode(queues, workerIndex, node))
+					this->expand(engine, recorder, node, outputs[workerIndex]);
+			};
+
+			runOnThreads(threadCount, worker);
+
+			return outputs;
+		}
+
+		static bool tryTakeNode(std::vector<WorkQueue> & queues, std::size_t workerIndex, Node & node)
+		{
+			{
+				WorkQueue & own = queues[workerIndex];
+				std::lock_guard<std::mutex> lock(own.mutex);
+
+				if(!own.nodes.empty())
+				{
+					node = std::move(own.nodes.back());
+					own.nodes.pop_back();
+					return true;
+				}
+			}
+
+			// Nothing is added to a level once it starts,
+			// so one pass over the other queues finds any work left
+			for(std::size_t offset = 1; offset < queues.size(); ++offset)
+			{
+				WorkQueue & victim = queues[(workerIndex + offset) % queues.size()];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+
+				if(!victim.nodes.empty())
+				{
+					node = std::move(victim.nodes.front());
+					victim.nodes.pop_front();
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Runs from a decision to the next one and queues every option of it
+		void expand(ScriptEngine & engine, TargetRecorder & recorder, const Node & node, WorkerOutput & output)
+		{
+			engine.restoreSnapshot(node.state);
+
+			const std::uint64_t limit = (engine.getExecutedCount() + this->options.maximumCommands);
+			EngineState state = engine.getState();
+
+			while(engine.getExecutedCount() < limit)
+			{
+				state = engine.step();
+
+				if((state == EngineState::AwaitingInput) || (state == EngineState::Delaying))
+				{
+					engine.resume();
+					state = EngineState::Running;
+				}
+
+				if(state != EngineState::Running)
+					break;
+			}
+
+			// Loops pass the same labels many times
+			auto & reached = recorder.getReached();
+			std::sort(reached.begin(), reached.end());
+			reached.erase(std::unique(reached.begin(), reached.end()), reached.end());
+
+			for(const std::size_t target : reached)
+				output.reached.emplace_back(target, node.path);
+
+			reached.clear();
+
+			switch(state)
+			{
+			case EngineState::Finished:
+				{
+					std::size_t target;
+					if((engine.getProgramCounter() > 0) && this->tryGetTarget(engine.getScriptIndex(), engine.getProgramCounter() - 1, target))
+						output.reached.emplace_back(target, node.path);
+				}
+				break;
+
+			case EngineState::Faulted:
+				++output.faultedCount;
+				break;
+
+			case EngineState::AwaitingChoice:
+			case EngineState::AwaitingRandom:
+				if(this->tryVisit(engine))
+				{
+					++output.visitedCount;
+					this->fork(engine, node, output);
+				}
+				break;
+
+			default:
+				++output.unfinishedCount;
+				break;
+			}
+		}
+
+		void fork(ScriptEngine & engine, const Node & node, WorkerOutput & output)
+		{
+			const RuntimeState state = engine.takeSnapshot();
+			const Command & command = this->novel.getScript(engine.getScriptIndex()).getCommand(engine.getProgramCounter() - 1);
+
+			if(state.getEngineState() == EngineState::AwaitingChoice)
+			{
+				// Choices that failed to parse their options still have one way on
+				const std::size_t choiceCount = std::max<std::size_t>(cast<ChoiceCommand>(command).getChoices().size(), 1);
+
+				for(std::size_t choice = 0; choice < choiceCount; ++choice)
+				{
+					engine.restoreSnapshot(state);
+					engine.selectChoice(choice);
+					this->addNode(engine, node, Decision { DecisionType::Choice, static_cast<int>(choice) }, output);
+				}
+			}
+			else
+			{
+				const auto & randomCommand = cast<RandomCommand>(command);
+				const int low = (std::min)(randomCommand.getLow(), randomCommand.getHigh());
+				const int high = (std::max)(randomCommand.getLow(), randomCommand.getHigh());
+
+				for(int value = low; ; ++value)
+				{
+					engine.restoreSnapshot(state);
+					engine.selectRandom(value);
+					this->addNode(engine, node, Decision { DecisionType::Random, value }, output);
+
+					if(value == high)
+						break;
+				}
+			}
+		}
+
+		void addNode(const ScriptEngine & engine, const Node & node, const Decision & decision, WorkerOutput & output)
+		{
+			output.next.push_back(Node { engine.takeSnapshot(), std::make_shared<const PathNode>(PathNode { node.path, decision }) });
+		}
+
+		// Returns false if an equal state was already visited
+		bool tryVisit(const ScriptEngine & engine)
+		{
+			const std::uint64_t hash = hashState(engine);
+			Shard & shard = this->shards[hash % shardCount];
+
+			std::lock_guard<std::mutex> lock(shard.mutex);
+
+			return shard.hashes.insert(hash).second;
+		}
+
+		static std::uint64_t hashState(const ScriptEngine & engine)
+		{
+			std::uint64_t hash = fnvOffsetBasis;
+
+			hash = combine(hash, engine.getScriptIndex());
+			hash = combine(hash, engine.getProgramCounter());
+			hash = combine(hash, static_cast<std::uint64_t>(engine.getState()));
+			hash = hashScope(hash, engine.getVariables().getLocals());
+			hash = hashScope(hash, engine.getVariables().getGlobals());
+
+			return hash;
+		}
+
+		static std::uint64_t hashScope(std::uint64_t hash, const VariableScope & scope)
+		{
+			for(std::uint32_t slot = 0; slot < scope.size(); ++slot)
+			{
+				if(!scope.isSet(slot))
+					continue;
+
+				const VariableValue & value = scope.get(slot);
+
+				hash = combine(hash, slot);
+
+				if(value.isInt())
+				{
+					hash = combine(hash, static_cast<std::uint32_t>(value.getInt()));
+				}
+				else
+				{
+					hash = combine(hash, 0x80000000u | static_cast<std::uint64_t>(value.getString().size()));
+
+					for(const char c : value.getString())
+						hash = combine(hash, static_cast<unsigned char>(c));
+				}
+			}
+
+			return hash;
+		}
+
+		static std::uint64_t combine(std::uint64_t hash, std::uint64_t value)
+		{
+			hash ^= value;
+			hash *= fnvPrime;
+			return (hash ^ (hash >> 29));
+		}
+
+		static std::vector<Decision> flattenPath(const Path & path)
+		{
+			std::vector<Decision> decisions;
+
+			for(const PathNode * node = path.get(); node != nullptr; node = node->parent.get())
+				decisions.push_back(node->decision);
+
+			std::reverse(decisions.begin(), decisions.end());
+			return decisions;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,482 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "VariableValue.h"
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace VNVita
+{
+	// Persists global variables as an append-only binary journal.
+	//
+	// Every change is encoded as one record and buffered,
+	// the buffer is written and synced every syncRecordCount records
+	// or when sync is called. Once the journal is past
+	// compactionThreshold and twice its size after the last
+	// compaction, it is rewritten in the background as one
+	// record per live variable.
+	//
+	// Layout: "VNGJ", version byte, then records:
+	//   'S' <name> 'I' <int32 LE>     set to an int
+	//   'S' <name> 'T' <text>         set to a string
+	//   'C'                           clear all (gsetvar ~ ~)
+	// where <name> and <text> are a LEB128 length followed by bytes.
+	class GlobalVariableJournal
+	{
+	public:
+		struct Options
+		{
+			std::size_t syncRecordCount = 16;
+			std::uintmax_t compactionThreshold = (64 * 1024);
+		};
+
+	private:
+		static constexpr const char * magic = "VNGJ";
+		static constexpr std::size_t headerSize = 5;
+		static constexpr char version = 1;
+
+		static constexpr char setRecord = 'S';
+		static constexpr char clearRecord = 'C';
+		static constexpr char intValue = 'I';
+		static constexpr char textValue = 'T';
+
+	private:
+		std::string path;
+		Options options;
+
+		std::FILE * file = nullptr;
+		std::uintmax_t fileSize = 0;
+
+		// The size after the last compaction, or as found when opened
+		std::uintmax_t compactedSize = 0;
+
+		std::unordered_map<std::string, VariableValue> variables;
+
+		std::string pending;
+		std::size_t pendingCount = 0;
+
+		bool isCompacting = false;
+		std::future<std::uintmax_t> compaction;
+		std::string compactionTail;
+
+	public:
+		GlobalVariableJournal(const std::string & path) :
+			path(path)
+		{
+		}
+
+		GlobalVariableJournal(const std::string & path, const Options & options) :
+			path(path), options(options)
+		{
+		}
+
+		GlobalVariableJournal(const GlobalVariableJournal &) = delete;
+		GlobalVariableJournal & operator =(const GlobalVariableJournal &) = delete;
+
+		~GlobalVariableJournal()
+		{
+			this->sync();
+
+			if(this->isCompacting)
+				this->finishCompaction();
+
+			if(this->file != nullptr)
+				std::fclose(this->file);
+		}
+
+		// Replays the journal and opens it for appending
+		bool tryOpen()
+		{
+			bool isIntact = true;
+
+			std::string contents;
+			if(readFile(this->path, contents))
+				isIntact = this->replay(contents);
+			else
+				isIntact = false;
+
+			// A missing, foreign or torn journal is rewritten from what was recovered
+			if(!isIntact)
+			{
+				const std::uintmax_t size = writeSnapshot(this->getCompactionPath(), this->variables);
+
+				if((size == 0) || !replaceFile(this->getCompactionPath(), this->path))
+					return false;
+
+				this->fileSize = size;
+			}
+			else
+			{
+				this->fileSize = contents.size();
+			}
+
+			this->compactedSize = this->fileSize;
+
+			this->file = std::fopen(this->path.c_str(), "ab");
+			return (this->file != nullptr);
+		}
+
+		const std::unordered_map<std::string, VariableValue> & getVariables() const
+		{
+			return this->variables;
+		}
+
+		std::uintmax_t getFileSize() const
+		{
+			return this->fileSize;
+		}
+
+		void set(const std::string & name, const VariableValue & value)
+		{
+			this->variables[name] = value;
+
+			this->pending += setRecord;
+			appendText(this->pending, name);
+
+			if(value.isInt())
+			{
+				this->pending += intValue;
+				appendInt(this->pending, value.getInt());
+			}
+			else
+			{
+				this->pending += textValue;
+				appendText(this->pending, value.getString());
+			}
+
+			this->onRecordAdded();
+		}
+
+		// A single tombstone record stands for every variable
+		void clear()
+		{
+			this->variables.clear();
+			this->pending += clearRecord;
+			this->onRecordAdded();
+		}
+
+		// Writes and syncs buffered records, and starts or
+		// completes a background compaction when one is due
+		void sync()
+		{
+			if(this->file == nullptr)
+				return;
+
+			if(!this->pending.empty())
+			{
+				std::fwrite(this->pending.data(), 1, this->pending.size(), this->file);
+				syncFile(this->file);
+
+				this->fileSize += this->pending.size();
+
+				if(this->isCompacting)
+					this->compactionTail += this->pending;
+
+				this->pending.clear();
+				this->pendingCount = 0;
+			}
+
+			if(this->isCompacting)
+			{
+				if(this->compaction.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+					this->finishCompaction();
+			}
+			else if((this->fileSize > this->options.compactionThreshold) && (this->fileSize >= (this->compactedSize * 2)))
+			{
+				this->startCompaction();
+			}
+		}
+
+	private:
+		std::string getCompactionPath() const
+		{
+			return (this->path + ".compact");
+		}
+
+		void onRecordAdded()
+		{
+			++this->pendingCount;
+
+			if(this->pendingCount >= this->options.syncRecordCount)
+				this->sync();
+		}
+
+		void startCompaction()
+		{
+			this->isCompacting = true;
+			this->compactionTail.clear();
+
+			// The snapshot is taken right after a sync,
+			// so everything later ends up in compactionTail
+			this->compaction = std::async(std::launch::async, [](std::string path, std::unordered_map<std::string, VariableValue> variables)
+			{
+				return writeSnapshot(path, variables);
+			}, this->getCompactionPath(), this->variables);
+		}
+
+		void finishCompaction()
+		{
+			this->isCompacting = false;
+
+			// Whatever happens, wait for the journal to double again before retrying
+			this->compactedSize = this->fileSize;
+
+			std::uintmax_t size = this->compaction.get();
+			if(size == 0)
+				return;
+
+			const std::string compactionPath = this->getCompactionPath();
+
+			std::FILE * compacted = std::fopen(compactionPath.c_str(), "ab");
+			if(compacted == nullptr)
+				return;
+
+			std::fwrite(this->compactionTail.data(), 1, this->compactionTail.size(), compacted);
+			syncFile(compacted);
+			std::fclose(compacted);
+
+			size += this->compactionTail.size();
+			this->compactionTail.clear();
+
+			std::fclose(this->file);
+
+			if(replaceFile(compactionPath, this->path))
+			{
+				this->fileSize = size;
+				this->compactedSize = size;
+			}
+
+			this->file = std::fopen(this->path.c_str(), "ab");
+		}
+
+		// Returns false if the journal was missing, foreign or ended in a torn record
+		bool replay(const std::string & contents)
+		{
+			if((contents.size() < headerSize) || (contents.compare(0, 4, magic) != 0) || (contents[4] != version))
+				return false;
+
+			std::size_t index = headerSize;
+
+			while(index < contents.size())
+			{
+				const char type = contents[index];
+				++index;
+
+				if(type == clearRecord)
+				{
+					this->variables.clear();
+					continue;
+				}
+
+				if(type != setRecord)
+					return false;
+
+				std::string name;
+				if(!tryReadText(contents, index, name) || (index >= contents.size()))
+					return false;
+
+				const char valueType = contents[index];
+				++index;
+
+				if(valueType == intValue)
+				{
+					int value;
+					if(!tryReadInt(contents, index, value))
+						return false;
+
+					this->variables[name] = VariableValue(value);
+				}
+				else if(valueType == textValue)
+				{
+					std::string value;
+					if(!tryReadText(contents, index, value))
+						return false;
+
+					this->variables[name] = VariableValue(std::move(value));
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		static void appendLength(std::string & output, std::size_t length)
+		{
+			while(length >= 0x80)
+			{
+				output += static_cast<char>((length & 0x7F) | 0x80);
+				length >>= 7;
+			}
+
+			output += static_cast<char>(length);
+		}
+
+		static void appendText(std::string & output, const std::string & text)
+		{
+			appendLength(output, text.size());
+			output += text;
+		}
+
+		static void appendInt(std::string & output, int value)
+		{
+			const auto bits = static_cast<std::uint32_t>(value);
+
+			for(int shift = 0; shift < 32; shift += 8)
+				output += static_cast<char>((bits >> shift) & 0xFF);
+		}
+
+		static bool tryReadLength(const std::string & input, std::size_t & index, std::size_t & length)
+		{
+			length = 0;
+
+			for(int shift = 0; index < input.size(); shift += 7)
+			{
+				const auto byte = static_cast<unsigned char>(input[index]);
+				++index;
+
+				length |= (static_cast<std::size_t>(byte & 0x7F) << shift);
+
+				if((byte & 0x80) == 0)
+					return true;
+			}
+
+			return false;
+		}
+
+		static bool tryReadText(const std::string & input, std::size_t & index, std::string & text)
+		{
+			std::size_t length;
+			if(!tryReadLength(input, index, length) || (length > (input.size() - index)))
+				return false;
+
+			text = input.substr(index, length);
+			index += length;
+			return true;
+		}
+
+		static bool tryReadInt(const std::string & input, std::size_t & index, int & value)
+		{
+			if((input.size() - index) < 4)
+				return false;
+
+			std::uint32_t bits = 0;
+
+			for(int shift = 0; shift < 32; shift += 8)
+			{
+				bits |= (static_cast<std::uint32_t>(static_cast<unsigned char>(input[index])) << shift);
+				++index;
+			}
+
+			value = static_cast<int>(bits);
+			return true;
+		}
+
+		static bool readFile(const std::string & path, std::string & contents)
+		{
+			std::FILE * input = std::fopen(path.c_str(), "rb");
+			if(input == nullptr)
+				return false;
+
+			char buffer[4096];
+			std::size_t count;
+			while((count = std::fread(buffer, 1, sizeof(buffer), input)) > 0)
+				contents.append(buffer, count);
+
+			std::fclose(input);
+			return true;
+		}
+
+		// Returns the size of the written journal, or 0 on failure
+		static std::uintmax_t writeSnapshot(const std::string & path, const std::unordered_map<std::string, VariableValue> & variables)
+		{
+			std::string output(magic);
+			output += version;
+
+			for(const auto & variable : variables)
+			{
+				output += setRecord;
+				appendText(output, variable.first);
+
+				if(variable.second.isInt())
+				{
+					output += intValue;
+					appendInt(output, variable.second.getInt());
+				}
+				else
+				{
+					output += textValue;
+					appendText(output, variable.second.getString());
+				}
+			}
+
+			std::FILE * snapshot = std::fopen(path.c_str(), "wb");
+			if(snapshot == nullptr)
+				return 0;
+
+			const bool isWritten = (std::fwrite(output.data(), 1, output.size(), snapshot) == output.size());
+			syncFile(snapshot);
+			std::fclose(snapshot);
+
+			return isWritten ? output.size() : 0;
+		}
+
+		static void syncFile(std::FILE * file)
+		{
+			std::fflush(file);
+
+#if defined(_WIN32)
+			_commit(_fileno(file));
+#else
+			fsync(fileno(file));
+#endif
+		}
+
+		static bool replaceFile(const std::string & source, const std::string & destination)
+		{
+#if defined(_WIN32)
+			return (MoveFileExA(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+			return (std::rename(source.c_str(), destination.c_str()) == 0);
+#endif
+		}
+	};
+}
\ No newline at end of file
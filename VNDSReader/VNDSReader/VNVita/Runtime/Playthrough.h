@@ -0,0 +1,269 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Novel.h"
+#include "../Parallel.h"
+#include "RuntimeState.h"
+#include "ScriptEventHandler.h"
+#include "ScriptEngine.h"
+
+namespace VNVita
+{
+	enum class ChoicePolicy : std::uint8_t
+	{
+		// Take choices from PlaythroughOptions::choices,
+		// falling back to Random once they run out
+		Scripted,
+
+		// Pick uniformly with an RNG seeded from PlaythroughOptions::seed
+		Random,
+	};
+
+	struct PlaythroughOptions
+	{
+		std::size_t scriptIndex = 0;
+		std::uint32_t seed = 0;
+		ChoicePolicy choicePolicy = ChoicePolicy::Random;
+		std::vector<std::size_t> choices;
+
+		// Stops scripts that loop forever
+		std::uint64_t maximumCommands = 10000000;
+
+		// Only the digest is kept when false
+		bool recordEvents = true;
+	};
+
+	enum class PlaythroughEventType : std::uint8_t
+	{
+		Label,
+		Text,
+		Choice,
+	};
+
+	// value is the text hash for Text and the chosen index for Choice
+	struct PlaythroughEvent
+	{
+		PlaythroughEventType type;
+		const std::string * label;
+		std::uint64_t value;
+	};
+
+	struct PlaythroughResult
+	{
+		EngineState finalState = EngineState::Finished;
+		std::uint64_t executedCount = 0;
+
+		// Folds every event in order, equal digests mean equal playthroughs
+		std::uint64_t digest = 0;
+
+		std::vector<PlaythroughEvent> events;
+	};
+
+	struct PlaythroughBatchResult
+	{
+		std::size_t runCount = 0;
+		std::size_t distinctDigestCount = 0;
+		std::size_t unfinishedCount = 0;
+		std::uint64_t executedCount = 0;
+		double seconds = 0;
+
+		double getCommandsPerSecond() const
+		{
+			return (this->seconds > 0) ? (static_cast<double>(this->executedCount) / this->seconds) : 0;
+		}
+	};
+
+	// Runs a novel headless from start to finish,
+	// logging the labels passed and a hash of every line of text
+	class PlaythroughRecorder : public ScriptEventHandler
+	{
+	private:
+		static constexpr std::uint64_t fnvOffsetBasis = 14695981039346656037ull;
+		static constexpr std::uint64_t fnvPrime = 1099511628211ull;
+
+	private:
+		PlaythroughResult & result;
+		bool recordEvents;
+
+	public:
+		PlaythroughRecorder(PlaythroughResult & result, bool recordEvents) :
+			result(result), recordEvents(recordEvents)
+		{
+			this->result.digest = fnvOffsetBasis;
+		}
+
+		void onLabel(const LabelCommand & labelCommand) override
+		{
+			this->addEvent(PlaythroughEventType::Label, &labelCommand.getLabel(), hashText(labelCommand.getLabel()));
+		}
+
+		void onText(const TextCommand & textCommand) override
+		{
+			this->addEvent(PlaythroughEventType::Text, nullptr, hashText(textCommand.getText()));
+		}
+
+		void onChoiceSelected(std::size_t choiceIndex)
+		{
+			this->addEvent(PlaythroughEventType::Choice, nullptr, choiceIndex);
+		}
+
+		// FNV-1a, stable across platforms so logs can be compared between machines
+		static std::uint64_t hashText(const std::string & text)
+		{
+			std::uint64_t hash = fnvOffsetBasis;
+
+			for(const char c : text)
+			{
+				hash ^= static_cast<unsigned char>(c);
+				hash *= fnvPrime;
+			}
+
+			return hash;
+		}
+
+	private:
+		void addEvent(PlaythroughEventType type, const std::string * label, std::uint64_t value)
+		{
+			this->result.digest ^= ((static_cast<std::uint64_t>(type) << 56) ^ value);
+			this->result.digest *= fnvPrime;
+
+			if(this->recordEvents)
+				this->result.events.push_back(PlaythroughEvent { type, label, value });
+		}
+	};
+
+	inline PlaythroughResult runPlaythrough(const Novel & novel, const PlaythroughOptions & options)
+	{
+		PlaythroughResult result;
+		PlaythroughRecorder recorder(result, options.recordEvents);
+
+		ScriptEngine engine(novel, recorder, options.seed);
+		engine.start(options.scriptIndex);
+
+		// Kept apart from the engine's RNG so the choice policy
+		// doesn't change the outcome of random commands
+		std::mt19937 choiceEngine(options.seed);
+		std::size_t nextChoice = 0;
+
+		while(engine.getExecutedCount() < options.maximumCommands)
+		{
+			const EngineState state = engine.step();
+
+			if(state == EngineState::Running)
+				continue;
+
+			if((state == EngineState::AwaitingInput) || (state == EngineState::Delaying))
+			{
+				engine.resume();
+				continue;
+			}
+
+			if(state != EngineState::AwaitingChoice)
+				break;
+
+			const auto & choiceCommand = cast<ChoiceCommand>(novel.getScript(engine.getScriptIndex()).getCommand(engine.getProgramCounter() - 1));
+			const std::size_t choiceCount = std::max<std::size_t>(choiceCommand.getChoices().size(), 1);
+
+			std::size_t choice;
+			if((options.choicePolicy == ChoicePolicy::Scripted) && (nextChoice < options.choices.size()))
+			{
+				choice = (std::min)(options.choices[nextChoice], choiceCount - 1);
+				++nextChoice;
+			}
+			else
+			{
+				choice = std::uniform_int_distribution<std::size_t>(0, choiceCount - 1)(choiceEngine);
+			}
+
+			recorder.onChoiceSelected(choice);
+			engine.selectChoice(choice);
+		}
+
+		result.finalState = engine.getState();
+		result.executedCount = engine.getExecutedCount();
+		return result;
+	}
+
+	// Runs runCount playthroughs seeded options.seed, options.seed + 1, ...
+	// spread over threadCount threads. Events aren't recorded.
+	inline PlaythroughBatchResult runPlaythroughs(const Novel & novel, const PlaythroughOptions & options, std::size_t runCount, std::size_t threadCount)
+	{
+		threadCount = (std::min)(getThreadCount(threadCount), std::max<std::size_t>(runCount, 1));
+
+		std::vector<std::uint64_t> digests(runCount);
+		std::vector<std::uint64_t> executedCounts(threadCount, 0);
+		std::vector<std::size_t> unfinishedCounts(threadCount, 0);
+		std::atomic<std::size_t> nextRun(0);
+
+		const auto worker = [&](std::size_t threadIndex)
+		{
+			PlaythroughOptions runOptions = options;
+			runOptions.recordEvents = false;
+
+			std::uint64_t executedCount = 0;
+			std::size_t unfinishedCount = 0;
+
+			for(std::size_t run = nextRun++; run < runCount; run = nextRun++)
+			{
+				runOptions.seed = static_cast<std::uint32_t>(options.seed + run);
+
+				const PlaythroughResult result = runPlaythrough(novel, runOptions);
+
+				digests[run] = result.digest;
+				executedCount += result.executedCount;
+
+				if(result.finalState != EngineState::Finished)
+					++unfinishedCount;
+			}
+
+			executedCounts[threadIndex] = executedCount;
+			unfinishedCounts[threadIndex] = unfinishedCount;
+		};
+
+		const auto start = std::chrono::steady_clock::now();
+
+		runOnThreads(threadCount, worker);
+
+		const auto end = std::chrono::steady_clock::now();
+
+		PlaythroughBatchResult batch;
+		batch.runCount = runCount;
+		batch.seconds = std::chrono::duration<double>(end - start).count();
+
+		for(std::size_t index = 0; index < threadCount; ++index)
+		{
+			batch.executedCount += executedCounts[index];
+			batch.unfinishedCount += unfinishedCounts[index];
+		}
+
+		std::sort(digests.begin(), digests.end());
+		batch.distinctDigestCount = static_cast<std::size_t>(std::unique(digests.begin(), digests.end()) - digests.begin());
+
+		return batch;
+	}
+}
\ No newline at end of file
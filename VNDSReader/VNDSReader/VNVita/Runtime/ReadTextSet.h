@@ -0,0 +1,99 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "../Novel.h"
+
+namespace VNVita
+{
+	// One bit per command of every script of a novel,
+	// set once the text command at that position has been shown
+	class ReadTextSet
+	{
+	private:
+		static constexpr std::size_t wordBits = 64;
+
+	private:
+		std::vector<std::size_t> offsets;
+		std::vector<std::uint64_t> words;
+
+	public:
+		ReadTextSet() = default;
+
+		ReadTextSet(const Novel & novel)
+		{
+			std::size_t bitCount = 0;
+
+			this->offsets.reserve(novel.size());
+
+			for(const auto & script : novel.getScripts())
+			{
+				this->offsets.push_back(bitCount);
+				bitCount += script.size();
+			}
+
+			this->words.assign((bitCount + wordBits - 1) / wordBits, 0);
+		}
+
+		bool isRead(std::size_t scriptIndex, std::size_t commandIndex) const
+		{
+			const std::size_t bit = (this->offsets[scriptIndex] + commandIndex);
+			return ((this->words[bit / wordBits] & (std::uint64_t(1) << (bit % wordBits))) != 0);
+		}
+
+		void markRead(std::size_t scriptIndex, std::size_t commandIndex)
+		{
+			const std::size_t bit = (this->offsets[scriptIndex] + commandIndex);
+			this->words[bit / wordBits] |= (std::uint64_t(1) << (bit % wordBits));
+		}
+
+		void clear()
+		{
+			for(auto & word : this->words)
+				word = 0;
+		}
+
+		// Only valid for the same novel, a changed script invalidates the set
+		void write(std::ostream & outputStream) const
+		{
+			const std::uint64_t count = this->words.size();
+			outputStream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+			outputStream.write(reinterpret_cast<const char *>(this->words.data()), static_cast<std::streamsize>(this->words.size() * sizeof(std::uint64_t)));
+		}
+
+		bool tryRead(std::istream & inputStream)
+		{
+			std::uint64_t count;
+			if(!inputStream.read(reinterpret_cast<char *>(&count), sizeof(count)) || (count != this->words.size()))
+				return false;
+
+			std::vector<std::uint64_t> words(this->words.size());
+			if(!inputStream.read(reinterpret_cast<char *>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(std::uint64_t))))
+				return false;
+
+			this->words = std::move(words);
+			return true;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,280 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Commands.h"
+#include "RuntimeState.h"
+#include "VariableStore.h"
+#include "VariableValue.h"
+
+namespace VNVita
+{
+	enum class RewindDeltaType : std::uint8_t
+	{
+		// A line of text was shown, rewinding stops here
+		Text,
+
+		LocalVariable,
+		GlobalVariable,
+		LocalsCleared,
+		GlobalsCleared,
+
+		// bgload, which also removes every image
+		Background,
+
+		// setimg, which adds one image to the end
+		ImageAdded,
+
+		// music, either played or stopped
+		Music,
+	};
+
+	// One undoable change, holding only what the change overwrote
+	struct RewindDelta
+	{
+		RewindDeltaType type;
+		bool wasSet;
+		std::uint32_t slot;
+		std::size_t scriptIndex;
+		std::size_t programCounter;
+		const TextCommand * text;
+		VariableValue oldValue;
+
+		// The old background or music
+		std::string oldPath;
+
+		// The images a bgload removed
+		std::vector<SceneImage> oldImages;
+
+		// The slots a clear unset, with their values
+		std::vector<std::pair<std::uint32_t, VariableValue>> oldSlots;
+	};
+
+	// Records the inverse of every state change a ScriptEngine makes,
+	// grouped into steps that each start with a shown line of text.
+	// When the recorded deltas exceed the byte budget the oldest steps
+	// are dropped whole, so every remaining step can be rewound.
+	//
+	// Every byte a delta owns counts towards the budget,
+	// strings by their capacity.
+	class RewindBuffer
+	{
+	public:
+		static constexpr std::size_t defaultByteBudget = (256 * 1024);
+
+	private:
+		std::deque<RewindDelta> deltas;
+		std::size_t byteBudget = defaultByteBudget;
+		std::size_t byteCount = 0;
+		std::size_t textCount = 0;
+
+	public:
+		RewindBuffer() = default;
+
+		RewindBuffer(std::size_t byteBudget) :
+			byteBudget(byteBudget)
+		{
+		}
+
+		std::size_t getByteBudget() const
+		{
+			return this->byteBudget;
+		}
+
+		void setByteBudget(std::size_t byteBudget)
+		{
+			this->byteBudget = byteBudget;
+			this->trim();
+		}
+
+		std::size_t getByteCount() const
+		{
+			return this->byteCount;
+		}
+
+		// The number of text lines that can be returned to
+		std::size_t getTextCount() const
+		{
+			return this->textCount;
+		}
+
+		void clear()
+		{
+			this->deltas.clear();
+			this->byteCount = 0;
+			this->textCount = 0;
+		}
+
+		// Oldest first
+		std::vector<const TextCommand *> getBacklog() const
+		{
+			std::vector<const TextCommand *> backlog;
+			backlog.reserve(this->textCount);
+
+			for(const auto & delta : this->deltas)
+				if(delta.type == RewindDeltaType::Text)
+					backlog.push_back(delta.text);
+
+			return backlog;
+		}
+
+		void recordText(const TextCommand & text, std::size_t scriptIndex, std::size_t programCounter)
+		{
+			RewindDelta delta = createDelta(RewindDeltaType::Text);
+			delta.text = &text;
+			delta.scriptIndex = scriptIndex;
+			delta.programCounter = programCounter;
+			this->push(std::move(delta));
+			++this->textCount;
+		}
+
+		void recordVariable(bool isGlobal, std::uint32_t slot, const VariableScope & scope)
+		{
+			// Deltas before the first line of text can never be rewound
+			if(this->textCount == 0)
+				return;
+
+			RewindDelta delta = createDelta(isGlobal ? RewindDeltaType::GlobalVariable : RewindDeltaType::LocalVariable);
+			delta.slot = slot;
+			delta.wasSet = scope.isSet(slot);
+			delta.oldValue = scope.get(slot);
+			this->push(std::move(delta));
+		}
+
+		void recordClear(bool isGlobal, const VariableScope & scope)
+		{
+			if(this->textCount == 0)
+				return;
+
+			RewindDelta delta = createDelta(isGlobal ? RewindDeltaType::GlobalsCleared : RewindDeltaType::LocalsCleared);
+			delta.oldSlots = scope.getSetValues();
+			this->push(std::move(delta));
+		}
+
+		// Call before bgload changes the scene
+		void recordBackground(const SceneState & scene)
+		{
+			if(this->textCount == 0)
+				return;
+
+			RewindDelta delta = createDelta(RewindDeltaType::Background);
+			delta.oldPath = scene.background;
+			delta.oldImages = scene.images;
+			this->push(std::move(delta));
+		}
+
+		void recordImageAdded()
+		{
+			if(this->textCount == 0)
+				return;
+
+			this->push(createDelta(RewindDeltaType::ImageAdded));
+		}
+
+		// Call before music is played or stopped
+		void recordMusic(const SceneState & scene)
+		{
+			if(this->textCount == 0)
+				return;
+
+			RewindDelta delta = createDelta(RewindDeltaType::Music);
+			delta.oldPath = scene.music;
+			this->push(std::move(delta));
+		}
+
+		bool isEmpty() const
+		{
+			return this->deltas.empty();
+		}
+
+		const RewindDelta & getLast() const
+		{
+			return this->deltas.back();
+		}
+
+		void removeLast()
+		{
+			const auto & delta = this->deltas.back();
+
+			if(delta.type == RewindDeltaType::Text)
+				--this->textCount;
+
+			this->byteCount -= getCost(delta);
+			this->deltas.pop_back();
+		}
+
+	private:
+		static RewindDelta createDelta(RewindDeltaType type)
+		{
+			return RewindDelta { type, false, 0, 0, 0, nullptr, VariableValue(), std::string(), {}, {} };
+		}
+
+		static std::size_t getCost(const VariableValue & value)
+		{
+			return value.isString() ? value.getString().capacity() : 0;
+		}
+
+		static std::size_t getCost(const RewindDelta & delta)
+		{
+			std::size_t cost = (sizeof(RewindDelta) + getCost(delta.oldValue) + delta.oldPath.capacity());
+
+			cost += (delta.oldImages.capacity() * sizeof(SceneImage));
+
+			for(const auto & image : delta.oldImages)
+				cost += image.path.capacity();
+
+			cost += (delta.oldSlots.capacity() * sizeof(std::pair<std::uint32_t, VariableValue>));
+
+			for(const auto & slot : delta.oldSlots)
+				cost += getCost(slot.second);
+
+			return cost;
+		}
+
+		void push(RewindDelta && delta)
+		{
+			this->byteCount += getCost(delta);
+			this->deltas.push_back(std::move(delta));
+			this->trim();
+		}
+
+		// Drops the oldest steps until the budget is met,
+		// always keeping the step being recorded
+		void trim()
+		{
+			while((this->byteCount > this->byteBudget) && (this->textCount > 1))
+			{
+				do
+				{
+					if(this->deltas.front().type == RewindDeltaType::Text)
+						--this->textCount;
+
+					this->byteCount -= getCost(this->deltas.front());
+					this->deltas.pop_front();
+				}
+				while(!this->deltas.empty() && (this->deltas.front().type != RewindDeltaType::Text));
+			}
+		}
+	};
+}
\ No newline at end of file
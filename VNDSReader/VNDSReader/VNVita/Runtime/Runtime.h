@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../Commands.h"
+
+#include "VariableValue.h"
+#include "VariableStore.h"
+#include "GlobalVariableJournal.h"
+#include "RuntimeState.h"
+#include "RewindBuffer.h"
+#include "ReadTextSet.h"
+#include "ScriptEventHandler.h"
+#include "ScriptEngine.h"
+#include "Playthrough.h"
+#include "BranchExplorer.h"
+#include "AssetCache.h"
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VariableStore.h"
+
+namespace VNVita
+{
+	enum class EngineState : std::uint8_t
+	{
+		// Ready to execute the next command
+		Running,
+
+		// Stopped after text that waits for the player
+		AwaitingInput,
+
+		// Stopped after a delay the front-end should wait out
+		Delaying,
+
+		// Stopped on a choice, resume with selectChoice
+		AwaitingChoice,
+
+		// Stopped on a random command while outcomes are external,
+		// resume with selectRandom
+		AwaitingRandom,
+
+		// Reached endscript or the end of a script
+		Finished,
+
+		// Hit a goto or jump whose target doesn't exist
+		Faulted,
+	};
+
+	struct SceneImage
+	{
+		std::string path;
+		int x;
+		int y;
+	};
+
+	// What bgload, setimg and music have put on screen and on the speakers
+	struct SceneState
+	{
+		std::string background;
+		std::vector<SceneImage> images;
+		std::string music;
+	};
+
+	// Everything needed to resume a ScriptEngine.
+	// Variables and scene are shared with the engine until it writes to them,
+	// so taking or restoring a RuntimeState is O(1).
+	class RuntimeState
+	{
+	private:
+		std::size_t scriptIndex = 0;
+		std::size_t programCounter = 0;
+		EngineState engineState = EngineState::Finished;
+		VariableStore variables;
+		std::shared_ptr<const SceneState> scene;
+
+	public:
+		RuntimeState() :
+			scene(std::make_shared<SceneState>())
+		{
+		}
+
+		RuntimeState(std::size_t scriptIndex, std::size_t programCounter, EngineState engineState, const VariableStore & variables, const std::shared_ptr<const SceneState> & scene) :
+			scriptIndex(scriptIndex), programCounter(programCounter), engineState(engineState), variables(variables), scene(scene)
+		{
+		}
+
+		std::size_t getScriptIndex() const
+		{
+			return this->scriptIndex;
+		}
+
+		std::size_t getProgramCounter() const
+		{
+			return this->programCounter;
+		}
+
+		EngineState getEngineState() const
+		{
+			return this->engineState;
+		}
+
+		const VariableStore & getVariables() const
+		{
+			return this->variables;
+		}
+
+		const SceneState & getScene() const
+		{
+			return *this->scene;
+		}
+
+		const std::shared_ptr<const SceneState> & getSharedScene() const
+		{
+			return this->scene;
+		}
+	};
+}
\ No newline at end of file
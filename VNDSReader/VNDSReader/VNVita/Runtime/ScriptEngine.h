@@ -0,0 +1,635 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include "../Commands.h"
+#include "../Novel.h"
+#include "ReadTextSet.h"
+#include "RewindBuffer.h"
+#include "RuntimeState.h"
+#include "ScriptEventHandler.h"
+#include "VariableStore.h"
+#include "VariableValue.h"
+
+namespace VNVita
+{
+	// Executes the commands of a Novel with a program counter.
+	// Control flow and variables are handled here,
+	// presentation commands are forwarded to a ScriptEventHandler.
+	class ScriptEngine
+	{
+	public:
+		using RandomEngine = std::mt19937;
+
+	private:
+		const Novel & novel;
+		ScriptEventHandler & handler;
+
+		// Points at silentHandler while skipping
+		ScriptEventHandler * presentationHandler;
+		ScriptEventHandler silentHandler;
+		bool isSkipping = false;
+
+		std::size_t scriptIndex = 0;
+		std::size_t programCounter = 0;
+		EngineState state = EngineState::Finished;
+
+		VariableStore variables;
+		std::shared_ptr<SceneState> scene = std::make_shared<SceneState>();
+
+		RandomEngine randomEngine;
+		std::uint64_t executedCount = 0;
+
+		RewindBuffer * rewindBuffer = nullptr;
+		ReadTextSet * readTextSet = nullptr;
+		bool isRandomExternal = false;
+
+	public:
+		ScriptEngine(const Novel & novel, ScriptEventHandler & handler) :
+			novel(novel), handler(handler), presentationHandler(&handler), variables(novel.getVariables().getSlotCount())
+		{
+		}
+
+		ScriptEngine(const Novel & novel, ScriptEventHandler & handler, RandomEngine::result_type seed) :
+			novel(novel), handler(handler), presentationHandler(&handler), variables(novel.getVariables().getSlotCount()), randomEngine(seed)
+		{
+		}
+
+		void seed(RandomEngine::result_type seed)
+		{
+			this->randomEngine.seed(seed);
+		}
+
+		void start(std::size_t scriptIndex, std::size_t commandIndex = 0)
+		{
+			this->scriptIndex = scriptIndex;
+			this->programCounter = commandIndex;
+			this->state = EngineState::Running;
+		}
+
+		bool tryStart(const std::string & scriptName)
+		{
+			std::size_t index;
+			if(!this->novel.tryGetScriptIndex(scriptName, index))
+				return false;
+
+			this->start(index);
+			return true;
+		}
+
+		EngineState getState() const
+		{
+			return this->state;
+		}
+
+		std::size_t getScriptIndex() const
+		{
+			return this->scriptIndex;
+		}
+
+		std::size_t getProgramCounter() const
+		{
+			return this->programCounter;
+		}
+
+		std::uint64_t getExecutedCount() const
+		{
+			return this->executedCount;
+		}
+
+		// Slots are assigned by the novel's VariableResolution
+		const VariableStore & getVariables() const
+		{
+			return this->variables;
+		}
+
+		VariableStore & getVariables()
+		{
+			return this->variables;
+		}
+
+		const SceneState & getScene() const
+		{
+			return *this->scene;
+		}
+
+		// O(1), the engine copies shared data only when it next writes to it
+		RuntimeState takeSnapshot() const
+		{
+			return RuntimeState(this->scriptIndex, this->programCounter, this->state, this->variables, this->scene);
+		}
+
+		// O(1), see takeSnapshot
+		void restoreSnapshot(const RuntimeState & snapshot)
+		{
+			this->scriptIndex = snapshot.getScriptIndex();
+			this->programCounter = snapshot.getProgramCounter();
+			this->state = snapshot.getEngineState();
+			this->variables = snapshot.getVariables();
+			this->scene = std::const_pointer_cast<SceneState>(snapshot.getSharedScene());
+		}
+
+		// Shown text is marked here, skip stops at text that isn't.
+		// Pass nullptr to stop tracking.
+		void setReadTextSet(ReadTextSet * readTextSet)
+		{
+			this->readTextSet = readTextSet;
+		}
+
+		// When set, random commands stop the engine instead of
+		// drawing from its RNG, so every outcome can be tried
+		void setExternalRandom(bool isRandomExternal)
+		{
+			this->isRandomExternal = isRandomExternal;
+		}
+
+		// Pass nullptr to stop recording
+		void setRewindBuffer(RewindBuffer * rewindBuffer)
+		{
+			this->rewindBuffer = rewindBuffer;
+		}
+
+		// Undoes recorded changes until the text shown the given
+		// number of lines ago is current again, and waits for input there.
+		// Returns the number of lines actually rewound.
+		std::size_t rewind(std::size_t lines)
+		{
+			if((this->rewindBuffer == nullptr) || (this->rewindBuffer->getTextCount() == 0))
+				return 0;
+
+			if(lines >= this->rewindBuffer->getTextCount())
+				lines = (this->rewindBuffer->getTextCount() - 1);
+
+			std::size_t rewound = 0;
+
+			while(true)
+			{
+				const RewindDelta & delta = this->rewindBuffer->getLast();
+
+				switch(delta.type)
+				{
+				case RewindDeltaType::Text:
+					if(rewound == lines)
+					{
+						this->scriptIndex = delta.scriptIndex;
+						this->programCounter = delta.programCounter;
+						this->state = EngineState::AwaitingInput;
+						return rewound;
+					}
+					++rewound;
+					break;
+
+				case RewindDeltaType::LocalVariable:
+					undoVariable(this->variables.getLocals(), delta);
+					break;
+
+				case RewindDeltaType::GlobalVariable:
+					undoVariable(this->variables.getGlobals(), delta);
+					break;
+
+				case RewindDeltaType::LocalsCleared:
+					undoClear(this->variables.getLocals(), delta);
+					break;
+
+				case RewindDeltaType::GlobalsCleared:
+					undoClear(this->variables.getGlobals(), delta);
+					break;
+
+				case RewindDeltaType::Background:
+					{
+						auto & scene = this->getWritableScene();
+						scene.background = delta.oldPath;
+						scene.images = delta.oldImages;
+					}
+					break;
+
+				case RewindDeltaType::ImageAdded:
+					this->getWritableScene().images.pop_back();
+					break;
+
+				case RewindDeltaType::Music:
+					this->getWritableScene().music = delta.oldPath;
+					break;
+				}
+
+				this->rewindBuffer->removeLast();
+			}
+		}
+
+		// Restores persisted globals, names no script uses are ignored
+		void loadGlobalVariables(const std::unordered_map<std::string, VariableValue> & globals)
+		{
+			for(const auto & global : globals)
+			{
+				std::uint32_t slot;
+				if(this->novel.getVariables().tryGetSlot(global.first, slot))
+					this->variables.getGlobals().set(slot, global.second);
+			}
+		}
+
+		// Continue after AwaitingInput or Delaying
+		void resume()
+		{
+			if((this->state == EngineState::AwaitingInput) || (this->state == EngineState::Delaying))
+				this->state = EngineState::Running;
+		}
+
+		// Choices are numbered from 0 here and stored 1-based as in VNDS
+		void selectChoice(std::size_t choiceIndex)
+		{
+			if(this->state != EngineState::AwaitingChoice)
+				return;
+
+			const auto slot = this->novel.getVariables().getSelectedSlot();
+
+			if(this->rewindBuffer != nullptr)
+				this->rewindBuffer->recordVariable(false, slot, this->variables.getLocals());
+
+			this->variables.getLocals().set(slot, VariableValue(static_cast<int>(choiceIndex + 1)));
+			this->state = EngineState::Running;
+		}
+
+		// The value is stored as is, it isn't checked against the command's range
+		void selectRandom(int value)
+		{
+			if(this->state != EngineState::AwaitingRandom)
+				return;
+
+			const auto slot = this->novel.getVariables().getCommand(this->scriptIndex, this->programCounter - 1).slot;
+
+			if(this->rewindBuffer != nullptr)
+				this->rewindBuffer->recordVariable(false, slot, this->variables.getLocals());
+
+			this->variables.getLocals().set(slot, VariableValue(value));
+			this->state = EngineState::Running;
+		}
+
+		// Executes commands until the engine stops running
+		EngineState run()
+		{
+			while(this->state == EngineState::Running)
+				this->executeNext();
+
+			return this->state;
+		}
+
+		// Runs up to the next unread line of text or choice without
+		// presentation events, then reports the resulting scene once.
+		// Global variable events are still sent.
+		EngineState skip()
+		{
+			if(this->readTextSet == nullptr)
+				return this->state;
+
+			this->isSkipping = true;
+			this->presentationHandler = &this->silentHandler;
+
+			while(this->isSkipping && (this->state == EngineState::Running))
+				this->executeNext();
+
+			this->isSkipping = false;
+			this->presentationHandler = &this->handler;
+
+			this->handler.onSceneChanged(*this->scene);
+
+			return this->state;
+		}
+
+		// Executes a single command
+		EngineState step()
+		{
+			if(this->state == EngineState::Running)
+				this->executeNext();
+
+			return this->state;
+		}
+
+	private:
+		void executeNext()
+		{
+			const Script & script = this->novel.getScript(this->scriptIndex);
+
+			if(this->programCounter >= script.size())
+			{
+				this->state = EngineState::Finished;
+				return;
+			}
+
+			const std::size_t index = this->programCounter;
+			const Command & command = script.getCommand(index);
+
+			if(this->isSkipping && this->isSkipStop(command, index))
+			{
+				this->isSkipping = false;
+				return;
+			}
+
+			++this->programCounter;
+			++this->executedCount;
+
+			switch(command.getKind())
+			{
+			case CommandKind::Label:
+				this->handler.onLabel(cast<LabelCommand>(command));
+				break;
+
+			case CommandKind::Skip:
+			case CommandKind::Fi:
+				break;
+
+			case CommandKind::EndScript:
+				this->state = EngineState::Finished;
+				break;
+
+			case CommandKind::If:
+				if(!this->evaluate(cast<IfCommand>(command), index))
+					this->skipBlock(script, index);
+				break;
+
+			case CommandKind::GoTo:
+				this->goTo(script, cast<GoToCommand>(command));
+				break;
+
+			case CommandKind::Jump:
+				this->jump(index);
+				break;
+
+			case CommandKind::SetLocalVariable:
+				this->assign(false, cast<SetLocalVariableCommand>(command).getOperation(), index);
+				break;
+
+			case CommandKind::ClearLocalVariables:
+				if(this->rewindBuffer != nullptr)
+					this->rewindBuffer->recordClear(false, this->variables.getLocals());
+
+				this->variables.getLocals().clear();
+				break;
+
+			case CommandKind::SetGlobalVariable:
+				{
+					const auto slot = this->assign(true, cast<SetGlobalVariableCommand>(command).getOperation(), index);
+					this->handler.onGlobalVariableSet(this->novel.getVariables().getName(slot), this->variables.getGlobals().get(slot));
+				}
+				break;
+
+			case CommandKind::ClearGlobalVariables:
+				if(this->rewindBuffer != nullptr)
+					this->rewindBuffer->recordClear(true, this->variables.getGlobals());
+
+				this->variables.getGlobals().clear();
+				this->handler.onGlobalVariablesCleared();
+				break;
+
+			case CommandKind::Random:
+				if(this->isRandomExternal)
+				{
+					this->state = EngineState::AwaitingRandom;
+				}
+				else
+				{
+					const auto & randomCommand = cast<RandomCommand>(command);
+					const int low = randomCommand.getLow();
+					const int high = randomCommand.getHigh();
+					std::uniform_int_distribution<int> distribution((low < high) ? low : high, (low < high) ? high : low);
+					const auto slot = this->novel.getVariables().getCommand(this->scriptIndex, index).slot;
+
+					if(this->rewindBuffer != nullptr)
+						this->rewindBuffer->recordVariable(false, slot, this->variables.getLocals());
+
+					this->variables.getLocals().set(slot, VariableValue(distribution(this->randomEngine)));
+				}
+				break;
+
+			case CommandKind::BackgroundLoad:
+				{
+					const auto & backgroundLoadCommand = cast<BackgroundLoadCommand>(command);
+
+					if(this->rewindBuffer != nullptr)
+						this->rewindBuffer->recordBackground(*this->scene);
+
+					auto & scene = this->getWritableScene();
+					scene.background = backgroundLoadCommand.getPath();
+					scene.images.clear();
+					this->presentationHandler->onBackgroundLoad(backgroundLoadCommand);
+				}
+				break;
+
+			case CommandKind::SetImage:
+				{
+					const auto & setImageCommand = cast<SetImageCommand>(command);
+
+					if(this->rewindBuffer != nullptr)
+						this->rewindBuffer->recordImageAdded();
+
+					this->getWritableScene().images.push_back(SceneImage { setImageCommand.getPath(), setImageCommand.getX(), setImageCommand.getY() });
+					this->presentationHandler->onSetImage(setImageCommand);
+				}
+				break;
+
+			case CommandKind::Choice:
+				this->presentationHandler->onChoice(cast<ChoiceCommand>(command));
+				this->state = EngineState::AwaitingChoice;
+				break;
+
+			case CommandKind::Delay:
+				this->presentationHandler->onDelay(cast<DelayCommand>(command));
+
+				if(!this->isSkipping)
+					this->state = EngineState::Delaying;
+				break;
+
+			case CommandKind::ClearText:
+				this->presentationHandler->onClearText(cast<ClearTextCommand>(command));
+				break;
+
+			case CommandKind::AwaitInput:
+				this->presentationHandler->onAwaitInput(cast<AwaitInputCommand>(command));
+
+				if(!this->isSkipping)
+					this->state = EngineState::AwaitingInput;
+				break;
+
+			case CommandKind::Text:
+				{
+					const auto & textCommand = cast<TextCommand>(command);
+
+					if(this->rewindBuffer != nullptr)
+						this->rewindBuffer->recordText(textCommand, this->scriptIndex, this->programCounter);
+
+					if(this->readTextSet != nullptr)
+						this->readTextSet->markRead(this->scriptIndex, index);
+
+					this->presentationHandler->onText(textCommand);
+
+					if(!this->isSkipping && (textCommand.getOption() == TextOption::AwaitInput))
+						this->state = EngineState::AwaitingInput;
+				}
+				break;
+
+			case CommandKind::PlayMusic:
+				{
+					const auto & playMusicCommand = cast<PlayMusicCommand>(command);
+
+					if(this->rewindBuffer != nullptr)
+						this->rewindBuffer->recordMusic(*this->scene);
+
+					this->getWritableScene().music = playMusicCommand.getPath();
+					this->presentationHandler->onPlayMusic(playMusicCommand);
+				}
+				break;
+
+			case CommandKind::StopMusic:
+				if(this->rewindBuffer != nullptr)
+					this->rewindBuffer->recordMusic(*this->scene);
+
+				this->getWritableScene().music.clear();
+				this->presentationHandler->onStopMusic(cast<StopMusicCommand>(command));
+				break;
+
+			case CommandKind::PlaySound:
+				this->presentationHandler->onPlaySound(cast<PlaySoundCommand>(command));
+				break;
+
+			case CommandKind::StopSound:
+				this->presentationHandler->onStopSound(cast<StopSoundCommand>(command));
+				break;
+			}
+		}
+
+		bool isSkipStop(const Command & command, std::size_t index) const
+		{
+			switch(command.getKind())
+			{
+			case CommandKind::Choice:
+				return true;
+
+			case CommandKind::Text:
+				return !this->readTextSet->isRead(this->scriptIndex, index);
+
+			default:
+				return false;
+			}
+		}
+
+		// Snapshots share the scene, so copy it before the first change
+		SceneState & getWritableScene()
+		{
+			if(this->scene.use_count() > 1)
+				this->scene = std::make_shared<SceneState>(*this->scene);
+
+			return *this->scene;
+		}
+
+		static void undoVariable(VariableScope & scope, const RewindDelta & delta)
+		{
+			if(delta.wasSet)
+				scope.set(delta.slot, delta.oldValue);
+			else
+				scope.unset(delta.slot);
+		}
+
+		// Every slot is unset after a clear, so setting the old ones restores it
+		static void undoClear(VariableScope & scope, const RewindDelta & delta)
+		{
+			for(const auto & slot : delta.oldSlots)
+				scope.set(slot.first, slot.second);
+		}
+
+		void skipBlock(const Script & script, std::size_t ifIndex)
+		{
+			std::size_t fiIndex;
+			if(script.getBlocks().tryGetMatchingFi(ifIndex, fiIndex))
+				this->programCounter = (fiIndex + 1);
+			else
+				this->programCounter = script.size();
+		}
+
+		void goTo(const Script & script, const GoToCommand & goToCommand)
+		{
+			std::size_t labelIndex;
+			if(script.getLabels().tryGetIndex(goToCommand.getLabel(), labelIndex))
+				this->programCounter = labelIndex;
+			else
+				this->state = EngineState::Faulted;
+		}
+
+		void jump(std::size_t index)
+		{
+			const auto target = this->novel.getJumps().tryGetTarget(this->scriptIndex, index);
+
+			if((target == nullptr) || !target->isResolved())
+			{
+				this->state = EngineState::Faulted;
+				return;
+			}
+
+			this->scriptIndex = target->targetScript;
+			this->programCounter = target->targetIndex;
+		}
+
+		bool evaluate(const IfCommand & ifCommand, std::size_t index) const
+		{
+			const auto & resolved = this->novel.getVariables().getCommand(this->scriptIndex, index);
+			VariableValue literal;
+			return VariableValue::compare(this->variables.get(resolved.slot), ifCommand.getOperation(), this->evaluateOperand(resolved.operand, literal));
+		}
+
+		// Returns the assigned slot
+		std::uint32_t assign(bool isGlobal, SetOperation operation, std::size_t index)
+		{
+			VariableScope & scope = isGlobal ? this->variables.getGlobals() : this->variables.getLocals();
+			const auto & resolved = this->novel.getVariables().getCommand(this->scriptIndex, index);
+
+			if(this->rewindBuffer != nullptr)
+				this->rewindBuffer->recordVariable(isGlobal, resolved.slot, scope);
+
+			VariableValue literal;
+			const VariableValue & right = this->evaluateOperand(resolved.operand, literal);
+
+			if(operation == SetOperation::Assign)
+				scope.set(resolved.slot, right);
+			else
+				scope.set(resolved.slot, VariableValue::apply(scope.get(resolved.slot), operation, right));
+
+			return resolved.slot;
+		}
+
+		// Int literals are materialised in literal, which doesn't allocate
+		const VariableValue & evaluateOperand(const Operand & operand, VariableValue & literal) const
+		{
+			switch(operand.type)
+			{
+			case OperandType::StringLiteral:
+				return this->novel.getVariables().getConstant(operand.value);
+
+			case OperandType::Variable:
+				return this->variables.get(static_cast<std::uint32_t>(operand.value));
+
+			default:
+				literal = VariableValue(operand.value);
+				return literal;
+			}
+		}
+	};
+}
\ No newline at end of file
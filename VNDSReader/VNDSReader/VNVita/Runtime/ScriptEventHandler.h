@@ -0,0 +1,113 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <string>
+
+#include "../Commands.h"
+#include "RuntimeState.h"
+#include "VariableValue.h"
+
+namespace VNVita
+{
+	// Receives the presentation commands executed by a ScriptEngine,
+	// and changes to global variables so they can be persisted.
+	// Every event defaults to doing nothing so a headless
+	// handler only needs to override what it cares about.
+	class ScriptEventHandler
+	{
+	public:
+		virtual ~ScriptEventHandler() = default;
+
+		virtual void onBackgroundLoad(const BackgroundLoadCommand & backgroundLoadCommand)
+		{
+			static_cast<void>(backgroundLoadCommand);
+		}
+
+		virtual void onSetImage(const SetImageCommand & setImageCommand)
+		{
+			static_cast<void>(setImageCommand);
+		}
+
+		virtual void onChoice(const ChoiceCommand & choiceCommand)
+		{
+			static_cast<void>(choiceCommand);
+		}
+
+		virtual void onDelay(const DelayCommand & delayCommand)
+		{
+			static_cast<void>(delayCommand);
+		}
+
+		virtual void onClearText(const ClearTextCommand & clearTextCommand)
+		{
+			static_cast<void>(clearTextCommand);
+		}
+
+		virtual void onAwaitInput(const AwaitInputCommand & awaitInputCommand)
+		{
+			static_cast<void>(awaitInputCommand);
+		}
+
+		virtual void onText(const TextCommand & textCommand)
+		{
+			static_cast<void>(textCommand);
+		}
+
+		virtual void onPlayMusic(const PlayMusicCommand & playMusicCommand)
+		{
+			static_cast<void>(playMusicCommand);
+		}
+
+		virtual void onStopMusic(const StopMusicCommand & stopMusicCommand)
+		{
+			static_cast<void>(stopMusicCommand);
+		}
+
+		virtual void onPlaySound(const PlaySoundCommand & playSoundCommand)
+		{
+			static_cast<void>(playSoundCommand);
+		}
+
+		virtual void onStopSound(const StopSoundCommand & stopSoundCommand)
+		{
+			static_cast<void>(stopSoundCommand);
+		}
+
+		// Sent for every label passed, including while skipping
+		virtual void onLabel(const LabelCommand & labelCommand)
+		{
+			static_cast<void>(labelCommand);
+		}
+
+		// Sent once after skipping, with the scene the skipped commands built
+		virtual void onSceneChanged(const SceneState & scene)
+		{
+			static_cast<void>(scene);
+		}
+
+		virtual void onGlobalVariableSet(const std::string & name, const VariableValue & value)
+		{
+			static_cast<void>(name);
+			static_cast<void>(value);
+		}
+
+		virtual void onGlobalVariablesCleared()
+		{
+		}
+	};
+}
\ No newline at end of file
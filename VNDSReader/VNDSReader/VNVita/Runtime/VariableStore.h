@@ -0,0 +1,234 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "VariableValue.h"
+
+namespace VNVita
+{
+	// Storage for one scope of variables, indexed by slot.
+	//
+	// Slots are grouped into fixed size chunks held by shared pointers,
+	// and the chunk table itself is shared too. Copying a scope is O(1),
+	// a write copies the table and the written chunk the first time
+	// it touches them after a copy, so snapshots stay cheap.
+	//
+	// Each scope tracks which storage it made itself and never gave out,
+	// rather than asking use_count, which can't be trusted while other
+	// threads drop their copies. Copying gives up the source's claim too,
+	// so a scope mustn't be copied by two threads at once.
+	class VariableScope
+	{
+	private:
+		static constexpr std::size_t chunkSize = 32;
+
+		struct Chunk
+		{
+			std::array<VariableValue, chunkSize> values;
+			std::uint32_t setMask = 0;
+		};
+
+		using ChunkTable = std::vector<std::shared_ptr<Chunk>>;
+
+	private:
+		std::shared_ptr<ChunkTable> chunks;
+		std::size_t slotCount = 0;
+
+		// Only meaningful while the table is owned
+		mutable bool ownsTable = false;
+		std::vector<bool> ownedChunks;
+
+	public:
+		VariableScope() :
+			VariableScope(0)
+		{
+		}
+
+		VariableScope(std::size_t slotCount) :
+			chunks(createTable(slotCount)), slotCount(slotCount), ownsTable(true), ownedChunks(this->chunks->size(), false)
+		{
+		}
+
+		VariableScope(const VariableScope & other) :
+			chunks(other.chunks), slotCount(other.slotCount)
+		{
+			other.ownsTable = false;
+		}
+
+		VariableScope(VariableScope &&) = default;
+
+		VariableScope & operator =(const VariableScope & other)
+		{
+			this->chunks = other.chunks;
+			this->slotCount = other.slotCount;
+			this->ownsTable = false;
+			other.ownsTable = false;
+			return *this;
+		}
+
+		VariableScope & operator =(VariableScope &&) = default;
+
+		std::size_t size() const
+		{
+			return this->slotCount;
+		}
+
+		bool isSet(std::uint32_t slot) const
+		{
+			const Chunk & chunk = *(*this->chunks)[slot / chunkSize];
+			return ((chunk.setMask & (std::uint32_t(1) << (slot % chunkSize))) != 0);
+		}
+
+		// Unset slots read as the int 0
+		const VariableValue & get(std::uint32_t slot) const
+		{
+			return (*this->chunks)[slot / chunkSize]->values[slot % chunkSize];
+		}
+
+		void set(std::uint32_t slot, const VariableValue & value)
+		{
+			Chunk & chunk = this->getWritableChunk(slot);
+			chunk.values[slot % chunkSize] = value;
+			chunk.setMask |= (std::uint32_t(1) << (slot % chunkSize));
+		}
+
+		void set(std::uint32_t slot, VariableValue && value)
+		{
+			Chunk & chunk = this->getWritableChunk(slot);
+			chunk.values[slot % chunkSize] = std::move(value);
+			chunk.setMask |= (std::uint32_t(1) << (slot % chunkSize));
+		}
+
+		void unset(std::uint32_t slot)
+		{
+			if(!this->isSet(slot))
+				return;
+
+			Chunk & chunk = this->getWritableChunk(slot);
+			chunk.values[slot % chunkSize] = VariableValue();
+			chunk.setMask &= ~(std::uint32_t(1) << (slot % chunkSize));
+		}
+
+		// Every set slot with its value, in slot order
+		std::vector<std::pair<std::uint32_t, VariableValue>> getSetValues() const
+		{
+			std::vector<std::pair<std::uint32_t, VariableValue>> values;
+
+			for(std::size_t chunkIndex = 0; chunkIndex < this->chunks->size(); ++chunkIndex)
+			{
+				const Chunk & chunk = *(*this->chunks)[chunkIndex];
+
+				for(std::size_t index = 0; index < chunkSize; ++index)
+					if((chunk.setMask & (std::uint32_t(1) << index)) != 0)
+						values.emplace_back(static_cast<std::uint32_t>((chunkIndex * chunkSize) + index), chunk.values[index]);
+			}
+
+			return values;
+		}
+
+		void clear()
+		{
+			this->chunks = createTable(this->slotCount);
+			this->ownsTable = true;
+			this->ownedChunks.assign(this->chunks->size(), false);
+		}
+
+		// True if both scopes still share all of their storage
+		bool isSharedWith(const VariableScope & other) const
+		{
+			return (this->chunks == other.chunks);
+		}
+
+	private:
+		Chunk & getWritableChunk(std::uint32_t slot)
+		{
+			if(!this->ownsTable)
+			{
+				this->chunks = std::make_shared<ChunkTable>(*this->chunks);
+				this->ownsTable = true;
+				this->ownedChunks.assign(this->chunks->size(), false);
+			}
+
+			const std::size_t index = (slot / chunkSize);
+			auto & chunk = (*this->chunks)[index];
+
+			if(!this->ownedChunks[index])
+			{
+				chunk = std::make_shared<Chunk>(*chunk);
+				this->ownedChunks[index] = true;
+			}
+
+			return *chunk;
+		}
+
+		// Every chunk starts out as the same shared empty chunk
+		static std::shared_ptr<ChunkTable> createTable(std::size_t slotCount)
+		{
+			static const auto emptyChunk = std::make_shared<Chunk>();
+			return std::make_shared<ChunkTable>((slotCount + chunkSize - 1) / chunkSize, emptyChunk);
+		}
+	};
+
+	// The local and global variables of a running novel
+	class VariableStore
+	{
+	private:
+		VariableScope locals;
+		VariableScope globals;
+
+	public:
+		VariableStore() = default;
+
+		VariableStore(std::size_t slotCount) :
+			locals(slotCount), globals(slotCount)
+		{
+		}
+
+		VariableScope & getLocals()
+		{
+			return this->locals;
+		}
+
+		const VariableScope & getLocals() const
+		{
+			return this->locals;
+		}
+
+		VariableScope & getGlobals()
+		{
+			return this->globals;
+		}
+
+		const VariableScope & getGlobals() const
+		{
+			return this->globals;
+		}
+
+		// Locals shadow globals
+		const VariableValue & get(std::uint32_t slot) const
+		{
+			return this->locals.isSet(slot) ? this->locals.get(slot) : this->globals.get(slot);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "../Commands.h"
+
+namespace VNVita
+{
+	enum class ValueType : std::uint8_t
+	{
+		Int,
+		String,
+	};
+
+	// The value of a VNDS variable, either an int or a string.
+	// Unset variables read as the int 0.
+	class VariableValue
+	{
+	private:
+		ValueType type = ValueType::Int;
+		int intValue = 0;
+		std::string stringValue;
+
+	public:
+		VariableValue() = default;
+
+		VariableValue(int value) :
+			type(ValueType::Int), intValue(value)
+		{
+		}
+
+		VariableValue(const std::string & value) :
+			type(ValueType::String), stringValue(value)
+		{
+		}
+
+		VariableValue(std::string && value) :
+			type(ValueType::String), stringValue(std::move(value))
+		{
+		}
+
+		ValueType getType() const
+		{
+			return this->type;
+		}
+
+		bool isInt() const
+		{
+			return (this->type == ValueType::Int);
+		}
+
+		bool isString() const
+		{
+			return (this->type == ValueType::String);
+		}
+
+		int getInt() const
+		{
+			return this->intValue;
+		}
+
+		const std::string & getString() const
+		{
+			return this->stringValue;
+		}
+
+		std::string toString() const
+		{
+			return this->isInt() ? std::to_string(this->intValue) : this->stringValue;
+		}
+
+		bool operator ==(const VariableValue & other) const
+		{
+			if(this->type != other.type)
+				return false;
+
+			return this->isInt() ? (this->intValue == other.intValue) : (this->stringValue == other.stringValue);
+		}
+
+		bool operator !=(const VariableValue & other) const
+		{
+			return !(*this == other);
+		}
+
+	public:
+		static VariableValue apply(const VariableValue & left, SetOperation operation, const VariableValue & right)
+		{
+			switch(operation)
+			{
+			case SetOperation::Assign:
+				return right;
+
+			case SetOperation::Add:
+				if(left.isInt() && right.isInt())
+					return VariableValue(wrap(static_cast<unsigned>(left.intValue) + static_cast<unsigned>(right.intValue)));
+				return VariableValue(left.toString() + right.toString());
+
+			case SetOperation::Subtract:
+				if(left.isInt() && right.isInt())
+					return VariableValue(wrap(static_cast<unsigned>(left.intValue) - static_cast<unsigned>(right.intValue)));
+				return left;
+
+			default:
+				return left;
+			}
+		}
+
+		// Int arithmetic is done unsigned, where wrapping around is defined,
+		// and brought back into range here
+		static int wrap(unsigned value)
+		{
+			if(value <= static_cast<unsigned>((std::numeric_limits<int>::max)()))
+				return static_cast<int>(value);
+
+			return (static_cast<int>(value - static_cast<unsigned>((std::numeric_limits<int>::min)())) + (std::numeric_limits<int>::min)());
+		}
+
+		// Ints compare numerically, anything involving a string compares as text
+		static bool compare(const VariableValue & left, IfOperation operation, const VariableValue & right)
+		{
+			const int order = (left.isInt() && right.isInt()) ?
+				((left.intValue < right.intValue) ? -1 : (left.intValue > right.intValue) ? 1 : 0) :
+				left.toString().compare(right.toString());
+
+			switch(operation)
+			{
+			case IfOperation::Equals:
+				return (order == 0);
+			case IfOperation::NotEquals:
+				return (order != 0);
+			case IfOperation::GreaterThan:
+				return (order > 0);
+			case IfOperation::LessThan:
+				return (order < 0);
+			case IfOperation::GreaterThanEquals:
+				return (order >= 0);
+			case IfOperation::LessThanEquals:
+				return (order <= 0);
+			default:
+				return false;
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Commands.h"
+#include "Analysis\IfBlockTable.h"
+#include "Analysis\LabelIndex.h"
+#include "Analysis\ControlFlowGraph.h"
+
+namespace VNVita
+{
+	// A filtered command list together with the tables
+	// that are computed once when the script is loaded.
+	class Script
+	{
+	private:
+		std::string path;
+		std::string name;
+		std::vector<std::shared_ptr<Command>> commands;
+		IfBlockTable blocks;
+		LabelIndex labels;
+		ControlFlowGraph flowGraph;
+
+	public:
+		Script() = default;
+
+		Script(const std::string & path, std::vector<std::shared_ptr<Command>> && commands) :
+			path(path), name(getFileName(path)), commands(std::move(commands)), blocks(this->commands), labels(this->commands), flowGraph(this->commands, this->blocks, this->labels)
+		{
+		}
+
+		Script(const std::string & path, const std::vector<std::shared_ptr<Command>> & commands) :
+			path(path), name(getFileName(path)), commands(commands), blocks(this->commands), labels(this->commands), flowGraph(this->commands, this->blocks, this->labels)
+		{
+		}
+
+		const std::string & getPath() const
+		{
+			return this->path;
+		}
+
+		// The file name used to refer to this script from a jump command
+		const std::string & getName() const
+		{
+			return this->name;
+		}
+
+		const std::vector<std::shared_ptr<Command>> & getCommands() const
+		{
+			return this->commands;
+		}
+
+		std::size_t size() const
+		{
+			return this->commands.size();
+		}
+
+		const Command & getCommand(std::size_t index) const
+		{
+			return *this->commands[index];
+		}
+
+		const IfBlockTable & getBlocks() const
+		{
+			return this->blocks;
+		}
+
+		const LabelIndex & getLabels() const
+		{
+			return this->labels;
+		}
+
+		const ControlFlowGraph & getFlowGraph() const
+		{
+			return this->flowGraph;
+		}
+
+	public:
+		static std::string getFileName(const std::string & path)
+		{
+			const auto position = path.find_last_of("/\\");
+
+			if(position == std::string::npos)
+				return path;
+
+			return path.substr(position + 1);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1 @@
+#include "Search\Search.h"
\ No newline at end of file
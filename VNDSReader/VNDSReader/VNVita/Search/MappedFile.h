@@ -0,0 +1,164 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <string>
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace VNVita
+{
+	// A read only view of a whole file, mapped into memory
+	class MappedFile
+	{
+	private:
+		const char * data = nullptr;
+		std::size_t size = 0;
+
+#if defined(_WIN32)
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#else
+		int file = -1;
+#endif
+
+	public:
+		MappedFile() = default;
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile & operator =(const MappedFile &) = delete;
+
+		~MappedFile()
+		{
+			this->close();
+		}
+
+		const char * getData() const
+		{
+			return this->data;
+		}
+
+		std::size_t getSize() const
+		{
+			return this->size;
+		}
+
+		bool isOpen() const
+		{
+			return (this->data != nullptr);
+		}
+
+		bool tryOpen(const std::string & path)
+		{
+			this->close();
+
+#if defined(_WIN32)
+			this->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if(this->file == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER fileSize;
+			if((GetFileSizeEx(this->file, &fileSize) == 0) || (fileSize.QuadPart == 0))
+			{
+				this->close();
+				return false;
+			}
+
+			this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(this->mapping == nullptr)
+			{
+				this->close();
+				return false;
+			}
+
+			this->data = static_cast<const char *>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+			this->size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+			this->file = open(path.c_str(), O_RDONLY);
+			if(this->file < 0)
+				return false;
+
+			struct stat status;
+			if((fstat(this->file, &status) != 0) || (status.st_size == 0))
+			{
+				this->close();
+				return false;
+			}
+
+			void * view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, this->file, 0);
+			if(view == MAP_FAILED)
+			{
+				this->close();
+				return false;
+			}
+
+			this->data = static_cast<const char *>(view);
+			this->size = static_cast<std::size_t>(status.st_size);
+#endif
+
+			if(this->data == nullptr)
+			{
+				this->close();
+				return false;
+			}
+
+			return true;
+		}
+
+		void close()
+		{
+#if defined(_WIN32)
+			if(this->data != nullptr)
+				UnmapViewOfFile(this->data);
+
+			if(this->mapping != nullptr)
+				CloseHandle(this->mapping);
+
+			if(this->file != INVALID_HANDLE_VALUE)
+				CloseHandle(this->file);
+
+			this->mapping = nullptr;
+			this->file = INVALID_HANDLE_VALUE;
+#else
+			if(this->data != nullptr)
+				munmap(const_cast<char *>(this->data), this->size);
+
+			if(this->file >= 0)
+				::close(this->file);
+
+			this->file = -1;
+#endif
+
+			this->data = nullptr;
+			this->size = 0;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "TextIndexFormat.h"
+#include "MappedFile.h"
+#include "TextIndexBuilder.h"
+#include "TextIndex.h"
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "TextIndexFormat.h"
+
+namespace VNVita
+{
+	struct TextHit
+	{
+		std::size_t scriptIndex;
+		std::size_t commandIndex;
+		std::size_t entryIndex;
+	};
+
+	// A text index written by TextIndexBuilder, searched in place
+	// through a memory map without reading the file up front.
+	//
+	// A query is matched as a case insensitive substring: the posting
+	// lists of its grams are intersected and the few entries left are
+	// checked against their text.
+	class TextIndex
+	{
+	private:
+		MappedFile file;
+
+		const TextIndexHeader * header = nullptr;
+		const TextIndexScript * scripts = nullptr;
+		const TextIndexEntry * entries = nullptr;
+		const TextIndexGram * grams = nullptr;
+		const std::uint32_t * postings = nullptr;
+		const char * stringPool = nullptr;
+
+	public:
+		bool tryOpen(const std::string & path)
+		{
+			if(!this->file.tryOpen(path) || (this->file.getSize() < sizeof(TextIndexHeader)))
+				return false;
+
+			const char * data = this->file.getData();
+			this->header = reinterpret_cast<const TextIndexHeader *>(data);
+
+			if((std::memcmp(this->header->magic, TextIndexFormat::magic, sizeof(this->header->magic)) != 0) || (this->header->version != TextIndexFormat::version))
+				return false;
+
+			// 64 bits so corrupt counts can't wrap the sum around
+			std::uint64_t offset = sizeof(TextIndexHeader);
+			std::uint64_t sectionOffsets[5];
+
+			sectionOffsets[0] = offset;
+			offset += (static_cast<std::uint64_t>(this->header->scriptCount) * sizeof(TextIndexScript));
+
+			sectionOffsets[1] = offset;
+			offset += (static_cast<std::uint64_t>(this->header->entryCount) * sizeof(TextIndexEntry));
+
+			sectionOffsets[2] = offset;
+			offset += (static_cast<std::uint64_t>(this->header->gramCount) * sizeof(TextIndexGram));
+
+			sectionOffsets[3] = offset;
+			offset += (static_cast<std::uint64_t>(this->header->postingCount) * sizeof(std::uint32_t));
+
+			sectionOffsets[4] = offset;
+			offset += this->header->stringPoolSize;
+
+			if(offset != this->file.getSize())
+				return false;
+
+			this->scripts = reinterpret_cast<const TextIndexScript *>(data + sectionOffsets[0]);
+			this->entries = reinterpret_cast<const TextIndexEntry *>(data + sectionOffsets[1]);
+			this->grams = reinterpret_cast<const TextIndexGram *>(data + sectionOffsets[2]);
+			this->postings = reinterpret_cast<const std::uint32_t *>(data + sectionOffsets[3]);
+			this->stringPool = (data + sectionOffsets[4]);
+
+			return this->hasValidRanges();
+		}
+
+		std::size_t getScriptCount() const
+		{
+			return this->header->scriptCount;
+		}
+
+		std::size_t getEntryCount() const
+		{
+			return this->header->entryCount;
+		}
+
+		std::string getScriptName(std::size_t scriptIndex) const
+		{
+			const TextIndexScript & script = this->scripts[scriptIndex];
+			return std::string(this->stringPool + script.nameOffset, script.nameLength);
+		}
+
+		std::string getText(std::size_t entryIndex) const
+		{
+			const TextIndexEntry & entry = this->entries[entryIndex];
+			return std::string(this->stringPool + entry.textOffset, entry.textLength);
+		}
+
+		// Hits in script order
+		std::vector<TextHit> search(const std::string & query) const
+		{
+			std::vector<TextHit> hits;
+
+			if(query.empty())
+				return hits;
+
+			for(const std::uint32_t entryIndex : this->findCandidates(query))
+			{
+				// Postings aren't checked when the index is opened
+				if(entryIndex >= this->header->entryCount)
+					continue;
+
+				const TextIndexEntry & entry = this->entries[entryIndex];
+
+				if(containsFolded(this->stringPool + entry.textOffset, entry.textLength, query))
+					hits.push_back(TextHit { entry.scriptIndex, entry.commandIndex, entryIndex });
+			}
+
+			return hits;
+		}
+
+	private:
+		static bool isInRange(std::uint32_t offset, std::uint32_t length, std::uint32_t size)
+		{
+			return ((static_cast<std::uint64_t>(offset) + length) <= size);
+		}
+
+		// Every string and posting list has to lie inside its section,
+		// or a corrupt index would be read past the end of the map
+		bool hasValidRanges() const
+		{
+			const TextIndexHeader & header = *this->header;
+
+			for(std::uint32_t index = 0; index < header.scriptCount; ++index)
+				if(!isInRange(this->scripts[index].nameOffset, this->scripts[index].nameLength, header.stringPoolSize))
+					return false;
+
+			for(std::uint32_t index = 0; index < header.entryCount; ++index)
+			{
+				const TextIndexEntry & entry = this->entries[index];
+
+				if((entry.scriptIndex >= header.scriptCount) || !isInRange(entry.textOffset, entry.textLength, header.stringPoolSize))
+					return false;
+			}
+
+			for(std::uint32_t index = 0; index < header.gramCount; ++index)
+				if(!isInRange(this->grams[index].postingOffset, this->grams[index].postingCount, header.postingCount))
+					return false;
+
+			return true;
+		}
+
+		// Entries holding every gram of the query, or every entry
+		// if the query is too short to have any
+		std::vector<std::uint32_t> findCandidates(const std::string & query) const
+		{
+			std::vector<std::uint32_t> candidates;
+
+			if(query.size() < TextIndexFormat::gramSize)
+			{
+				candidates.resize(this->header->entryCount);
+
+				for(std::uint32_t index = 0; index < this->header->entryCount; ++index)
+					candidates[index] = index;
+
+				return candidates;
+			}
+
+			std::vector<const TextIndexGram *> queryGrams;
+
+			for(std::size_t index = 0; (index + TextIndexFormat::gramSize) <= query.size(); ++index)
+			{
+				const TextIndexGram * gram = this->findGram(TextIndexFormat::getGram(query, index));
+
+				// A gram no text has rules out every entry
+				if(gram == nullptr)
+					return candidates;
+
+				queryGrams.push_back(gram);
+			}
+
+			// Start from the rarest gram so the working set stays small
+			std::sort(queryGrams.begin(), queryGrams.end(), [](const TextIndexGram * left, const TextIndexGram * right)
+			{
+				return (left->postingCount < right->postingCount);
+			});
+
+			const std::uint32_t * first = (this->postings + queryGrams[0]->postingOffset);
+			candidates.assign(first, first + queryGrams[0]->postingCount);
+
+			std::vector<std::uint32_t> remaining;
+
+			for(std::size_t index = 1; (index < queryGrams.size()) && !candidates.empty(); ++index)
+			{
+				const std::uint32_t * begin = (this->postings + queryGrams[index]->postingOffset);
+				const std::uint32_t * end = (begin + queryGrams[index]->postingCount);
+
+				remaining.clear();
+				std::set_intersection(candidates.begin(), candidates.end(), begin, end, std::back_inserter(remaining));
+				candidates.swap(remaining);
+			}
+
+			return candidates;
+		}
+
+		const TextIndexGram * findGram(std::uint32_t gram) const
+		{
+			const TextIndexGram * end = (this->grams + this->header->gramCount);
+
+			const TextIndexGram * iterator = std::lower_bound(this->grams, end, gram, [](const TextIndexGram & entry, std::uint32_t value)
+			{
+				return (entry.gram < value);
+			});
+
+			return ((iterator != end) && (iterator->gram == gram)) ? iterator : nullptr;
+		}
+
+		static bool containsFolded(const char * text, std::size_t length, const std::string & query)
+		{
+			if(query.size() > length)
+				return false;
+
+			for(std::size_t start = 0; (start + query.size()) <= length; ++start)
+			{
+				std::size_t index = 0;
+
+				while((index < query.size()) && (TextIndexFormat::foldCase(text[start + index]) == TextIndexFormat::foldCase(query[index])))
+					++index;
+
+				if(index == query.size())
+					return true;
+			}
+
+			return false;
+		}
+	};
+}
\ No newline at end of file
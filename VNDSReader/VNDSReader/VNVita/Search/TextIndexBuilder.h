@@ -0,0 +1,246 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Parallel.h"
+#include "../Script.h"
+#include "TextIndexFormat.h"
+
+namespace VNVita
+{
+	// Writes a TextIndex for the text and choice commands of a set of scripts.
+	// Scripts are read in parallel, the index is the same whatever the thread count.
+	class TextIndexBuilder
+	{
+	private:
+		struct Text
+		{
+			std::uint32_t commandIndex;
+			std::string text;
+		};
+
+		// Gram and entry number
+		using Posting = std::pair<std::uint32_t, std::uint32_t>;
+
+	private:
+		const std::vector<Script> & scripts;
+		std::vector<std::vector<Text>> texts;
+
+		// Sorted and free of duplicates
+		std::vector<Posting> postings;
+
+	public:
+		TextIndexBuilder(const std::vector<Script> & scripts, std::size_t threadCount = 0) :
+			scripts(scripts), texts(scripts.size())
+		{
+			threadCount = getThreadCount(threadCount);
+
+			// Each script's postings are numbered from its own first entry
+			// until the entry counts of the scripts before it are known
+			std::vector<std::vector<Posting>> runs(scripts.size());
+
+			forEachInParallel(scripts.size(), threadCount, [this, &runs](std::size_t index)
+			{
+				this->texts[index] = extractTexts(this->scripts[index]);
+				runs[index] = makePostings(this->texts[index]);
+			});
+
+			std::uint32_t firstEntry = 0;
+
+			for(std::size_t index = 0; index < runs.size(); ++index)
+			{
+				for(auto & posting : runs[index])
+					posting.second += firstEntry;
+
+				firstEntry += static_cast<std::uint32_t>(this->texts[index].size());
+			}
+
+			this->postings = mergeRuns(std::move(runs), threadCount);
+		}
+
+		std::size_t getEntryCount() const
+		{
+			std::size_t count = 0;
+
+			for(const auto & scriptTexts : this->texts)
+				count += scriptTexts.size();
+
+			return count;
+		}
+
+		bool tryWrite(const std::string & path) const
+		{
+			std::string stringPool;
+			std::vector<TextIndexScript> scriptTable;
+			std::vector<TextIndexEntry> entries;
+
+			for(std::size_t scriptIndex = 0; scriptIndex < this->scripts.size(); ++scriptIndex)
+			{
+				const std::string & name = this->scripts[scriptIndex].getName();
+				scriptTable.push_back(TextIndexScript { static_cast<std::uint32_t>(stringPool.size()), static_cast<std::uint32_t>(name.size()) });
+				stringPool += name;
+
+				for(const auto & text : this->texts[scriptIndex])
+				{
+					entries.push_back(TextIndexEntry { static_cast<std::uint32_t>(scriptIndex), text.commandIndex, static_cast<std::uint32_t>(stringPool.size()), static_cast<std::uint32_t>(text.text.size()) });
+					stringPool += text.text;
+				}
+			}
+
+			std::vector<TextIndexGram> grams;
+			std::vector<std::uint32_t> postingList;
+			postingList.reserve(this->postings.size());
+
+			for(const auto & posting : this->postings)
+			{
+				if(grams.empty() || (grams.back().gram != posting.first))
+					grams.push_back(TextIndexGram { posting.first, static_cast<std::uint32_t>(postingList.size()), 0 });
+
+				++grams.back().postingCount;
+				postingList.push_back(posting.second);
+			}
+
+			TextIndexHeader header;
+			std::memcpy(header.magic, TextIndexFormat::magic, sizeof(header.magic));
+			header.version = TextIndexFormat::version;
+			header.scriptCount = static_cast<std::uint32_t>(scriptTable.size());
+			header.entryCount = static_cast<std::uint32_t>(entries.size());
+			header.gramCount = static_cast<std::uint32_t>(grams.size());
+			header.postingCount = static_cast<std::uint32_t>(postingList.size());
+			header.stringPoolSize = static_cast<std::uint32_t>(stringPool.size());
+
+			std::ofstream output(path, std::ios::binary);
+
+			writeArray(output, &header, 1);
+			writeArray(output, scriptTable.data(), scriptTable.size());
+			writeArray(output, entries.data(), entries.size());
+			writeArray(output, grams.data(), grams.size());
+			writeArray(output, postingList.data(), postingList.size());
+			writeArray(output, stringPool.data(), stringPool.size());
+
+			return static_cast<bool>(output);
+		}
+
+	private:
+		// Sorting by gram then entry also brings repeats together
+		static std::vector<Posting> makePostings(const std::vector<Text> & texts)
+		{
+			std::vector<Posting> postings;
+
+			for(std::size_t entryIndex = 0; entryIndex < texts.size(); ++entryIndex)
+			{
+				const std::string & text = texts[entryIndex].text;
+
+				for(std::size_t index = 0; (index + TextIndexFormat::gramSize) <= text.size(); ++index)
+					postings.emplace_back(TextIndexFormat::getGram(text, index), static_cast<std::uint32_t>(entryIndex));
+			}
+
+			std::sort(postings.begin(), postings.end());
+			postings.erase(std::unique(postings.begin(), postings.end()), postings.end());
+
+			return postings;
+		}
+
+		// Merges neighbouring runs in pairs, the pairs of each round in parallel.
+		// No two runs share an entry, so the result is free of duplicates.
+		static std::vector<Posting> mergeRuns(std::vector<std::vector<Posting>> runs, std::size_t threadCount)
+		{
+			if(runs.empty())
+				return std::vector<Posting>();
+
+			while(runs.size() > 1)
+			{
+				const std::size_t pairCount = (runs.size() / 2);
+				std::vector<std::vector<Posting>> merged((runs.size() + 1) / 2);
+
+				forEachInParallel(pairCount, threadCount, [&runs, &merged](std::size_t index)
+				{
+					auto & left = runs[index * 2];
+					auto & right = runs[(index * 2) + 1];
+
+					merged[index].resize(left.size() + right.size());
+					std::merge(left.begin(), left.end(), right.begin(), right.end(), merged[index].begin());
+
+					std::vector<Posting>().swap(left);
+					std::vector<Posting>().swap(right);
+				});
+
+				if((runs.size() % 2) != 0)
+					merged.back() = std::move(runs.back());
+
+				runs = std::move(merged);
+			}
+
+			return std::move(runs[0]);
+		}
+
+		static std::vector<Text> extractTexts(const Script & script)
+		{
+			std::vector<Text> texts;
+
+			for(std::size_t index = 0; index < script.size(); ++index)
+			{
+				const Command & command = script.getCommand(index);
+				std::string text;
+
+				if(const auto textCommand = tryCast<TextCommand>(&command))
+				{
+					text = textCommand->getText();
+				}
+				else if(const auto choiceCommand = tryCast<ChoiceCommand>(&command))
+				{
+					for(const auto & choice : choiceCommand->getChoices())
+					{
+						if(!text.empty())
+							text += '|';
+
+						text += choice;
+					}
+				}
+				else
+				{
+					continue;
+				}
+
+				// Operands keep the space that separated them from the command
+				const auto first = text.find_first_not_of(" \t");
+				if(first == std::string::npos)
+					continue;
+
+				texts.push_back(Text { static_cast<std::uint32_t>(index), text.substr(first) });
+			}
+
+			return texts;
+		}
+
+		template<typename Type>
+		static void writeArray(std::ofstream & output, const Type * data, std::size_t count)
+		{
+			output.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(count * sizeof(Type)));
+		}
+	};
+}
\ No newline at end of file
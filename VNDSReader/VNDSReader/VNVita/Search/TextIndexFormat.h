@@ -0,0 +1,98 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace VNVita
+{
+	// Layout of a text index file. Every field is a 32-bit integer
+	// in the byte order of the machine that wrote it:
+	//
+	//   TextIndexHeader
+	//   TextIndexScript[scriptCount]   names, as spans of the string pool
+	//   TextIndexEntry[entryCount]     one per text or choice command
+	//   TextIndexGram[gramCount]       sorted by gram
+	//   uint32[postingCount]           entry numbers, sorted per gram
+	//   char[stringPoolSize]           names and texts
+	//
+	// A gram is three bytes of case folded text packed into an integer,
+	// so any text, whatever its script or language, can be searched.
+	struct TextIndexHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t scriptCount;
+		std::uint32_t entryCount;
+		std::uint32_t gramCount;
+		std::uint32_t postingCount;
+		std::uint32_t stringPoolSize;
+	};
+
+	struct TextIndexScript
+	{
+		std::uint32_t nameOffset;
+		std::uint32_t nameLength;
+	};
+
+	struct TextIndexEntry
+	{
+		std::uint32_t scriptIndex;
+
+		// The command index of the unoptimised script. Only at -O0 is it
+		// also the line of the command in the .vnvita file, less one.
+		std::uint32_t commandIndex;
+
+		std::uint32_t textOffset;
+		std::uint32_t textLength;
+	};
+
+	struct TextIndexGram
+	{
+		std::uint32_t gram;
+		std::uint32_t postingOffset;
+		std::uint32_t postingCount;
+	};
+
+	class TextIndexFormat
+	{
+	public:
+		static constexpr const char * magic = "VNTI";
+		static constexpr std::uint32_t version = 1;
+		static constexpr std::size_t gramSize = 3;
+
+	public:
+		// Only ASCII is folded, other bytes are compared as they are
+		static char foldCase(char c)
+		{
+			return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c - 'A' + 'a') : c;
+		}
+
+		// text must have at least gramSize bytes from index
+		static std::uint32_t getGram(const std::string & text, std::size_t index)
+		{
+			std::uint32_t gram = 0;
+
+			for(std::size_t offset = 0; offset < gramSize; ++offset)
+				gram = ((gram << 8) | static_cast<unsigned char>(foldCase(text[index + offset])));
+
+			return gram;
+		}
+	};
+}
\ No newline at end of file
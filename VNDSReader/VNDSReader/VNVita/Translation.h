@@ -0,0 +1 @@
+#include "Translation\Translation.h"
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <string>
+
+namespace VNVita
+{
+	// One translatable string of a script.
+	//
+	// Its id is the script name, the source line, counted from 1,
+	// and the part of the line: 0 for text, the option index for a choice.
+	// The original is kept so strings that changed since they were
+	// extracted aren't replaced with a stale translation.
+	struct CatalogEntry
+	{
+		std::string scriptName;
+		std::size_t line;
+		std::size_t part;
+		std::string original;
+		std::string translation;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../CharReaders.h"
+#include "../Parser.h"
+#include "CatalogEntry.h"
+#include "CatalogWriter.h"
+#include "TextSpans.h"
+
+namespace VNVita
+{
+	// Streams a script a line at a time and writes every text
+	// and choice string to the catalog, untranslated.
+	// Memory use doesn't grow with the size of the script.
+	// Returns the number of entries written.
+	inline std::size_t extractCatalog(std::istream & source, const std::string & scriptName, CatalogWriter & writer)
+	{
+		std::size_t count = 0;
+
+		std::string line;
+		std::vector<TextSpan> spans;
+
+		CatalogEntry entry;
+		entry.scriptName = scriptName;
+
+		for(std::size_t lineNumber = 1; std::getline(source, line); ++lineNumber)
+		{
+			Parser parser(std::make_shared<StringCharReader>(line));
+
+			ParseResult result;
+			if(!parser.tryParseNextCommand(result))
+				continue;
+
+			findTextSpans(line, *result.getCommand(), spans);
+
+			for(std::size_t part = 0; part < spans.size(); ++part)
+			{
+				if(spans[part].length == 0)
+					continue;
+
+				entry.line = lineNumber;
+				entry.part = part;
+				entry.original.assign(line, spans[part].first, spans[part].length);
+				entry.translation = entry.original;
+
+				writer.write(entry);
+				++count;
+			}
+		}
+
+		return count;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../CharReaders.h"
+#include "../Parser.h"
+#include "CatalogEntry.h"
+#include "CatalogReader.h"
+#include "TextSpans.h"
+
+namespace VNVita
+{
+	struct InjectReport
+	{
+		std::size_t translatedCount = 0;
+
+		// Entries whose line no longer holds their original string
+		std::size_t staleCount = 0;
+
+		// Translations that would break the line they go in,
+		// a line break anywhere or a '|' in a choice option
+		std::size_t rejectedCount = 0;
+
+		// The catalog line that couldn't be read, 0 if none
+		std::size_t malformedLine = 0;
+	};
+
+	// Streams a script a line at a time, replacing strings with
+	// their translation from a catalog in the order extractCatalog
+	// wrote it, and copying everything else through unchanged.
+	// Only lines with an entry are parsed. Entries for other scripts
+	// are skipped, so catalogs can be concatenated.
+	inline InjectReport injectCatalog(std::istream & source, CatalogReader & catalog, const std::string & scriptName, std::ostream & output)
+	{
+		InjectReport report;
+
+		CatalogEntry next;
+		bool hasNext = false;
+
+		const auto readNext = [&]()
+		{
+			while((hasNext = catalog.tryReadNext(next)))
+				if(next.scriptName == scriptName)
+					return;
+
+			if(catalog.hasMalformedLine())
+				report.malformedLine = catalog.getLineNumber();
+		};
+
+		readNext();
+
+		std::string line;
+		std::vector<TextSpan> spans;
+		std::vector<CatalogEntry> lineEntries;
+
+		for(std::size_t lineNumber = 1; std::getline(source, line); ++lineNumber)
+		{
+			lineEntries.clear();
+
+			while(hasNext && (next.line <= lineNumber))
+			{
+				if(next.line == lineNumber)
+					lineEntries.push_back(std::move(next));
+				else
+					++report.staleCount;
+
+				readNext();
+			}
+
+			if(!lineEntries.empty())
+			{
+				Parser parser(std::make_shared<StringCharReader>(line));
+
+				bool isChoice = false;
+
+				ParseResult result;
+				if(parser.tryParseNextCommand(result))
+				{
+					findTextSpans(line, *result.getCommand(), spans);
+					isChoice = isa<ChoiceCommand>(result.getCommand().get());
+				}
+				else
+				{
+					spans.clear();
+				}
+
+				const char * const forbidden = (isChoice ? "\n\r|" : "\n\r");
+
+				// Last part first, so replacing one doesn't move the others
+				std::sort(lineEntries.begin(), lineEntries.end(), [](const CatalogEntry & left, const CatalogEntry & right)
+				{
+					return (left.part > right.part);
+				});
+
+				for(const auto & entry : lineEntries)
+				{
+					if((entry.part >= spans.size()) || (line.compare(spans[entry.part].first, spans[entry.part].length, entry.original) != 0))
+					{
+						++report.staleCount;
+						continue;
+					}
+
+					if(entry.translation.find_first_of(forbidden) != std::string::npos)
+					{
+						++report.rejectedCount;
+						continue;
+					}
+
+					line.replace(spans[entry.part].first, spans[entry.part].length, entry.translation);
+					++report.translatedCount;
+				}
+			}
+
+			output << line;
+
+			// Keep a missing line break at the end of the file missing
+			if(!source.eof())
+				output << '\n';
+		}
+
+		while(hasNext)
+		{
+			++report.staleCount;
+			readNext();
+		}
+
+		return report;
+	}
+}
\ No newline at end of file
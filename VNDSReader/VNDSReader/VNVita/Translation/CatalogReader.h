@@ -0,0 +1,146 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+#include "CatalogEntry.h"
+
+namespace VNVita
+{
+	// Reads back what CatalogWriter wrote, one entry at a time
+	class CatalogReader
+	{
+	private:
+		std::istream & inputStream;
+		std::string line;
+		std::size_t lineNumber = 0;
+		bool isMalformed = false;
+
+	public:
+		CatalogReader(std::istream & inputStream) :
+			inputStream(inputStream)
+		{
+		}
+
+		// The catalog line of the last entry read, or of the malformed line
+		std::size_t getLineNumber() const
+		{
+			return this->lineNumber;
+		}
+
+		bool hasMalformedLine() const
+		{
+			return this->isMalformed;
+		}
+
+		// Returns false at the end of the catalog or at a malformed line
+		bool tryReadNext(CatalogEntry & entry)
+		{
+			while(std::getline(this->inputStream, this->line))
+			{
+				++this->lineNumber;
+
+				if(!this->line.empty() && (this->line.back() == '\r'))
+					this->line.pop_back();
+
+				if(this->line.empty())
+					continue;
+
+				this->isMalformed = !tryParseEntry(this->line, entry);
+				return !this->isMalformed;
+			}
+
+			return false;
+		}
+
+	private:
+		static bool tryParseEntry(const std::string & line, CatalogEntry & entry)
+		{
+			const auto idEnd = line.find('\t');
+			if(idEnd == std::string::npos)
+				return false;
+
+			const auto originalEnd = line.find('\t', idEnd + 1);
+			if(originalEnd == std::string::npos)
+				return false;
+
+			// The script name may itself hold colons and dots
+			const auto colon = line.rfind(':', idEnd);
+			const auto dot = line.rfind('.', idEnd);
+			if((colon == std::string::npos) || (dot == std::string::npos) || (dot < colon))
+				return false;
+
+			if(!tryParseNumber(line, colon + 1, dot, entry.line) || !tryParseNumber(line, dot + 1, idEnd, entry.part))
+				return false;
+
+			entry.scriptName.assign(line, 0, colon);
+
+			return tryUnescape(line, idEnd + 1, originalEnd, entry.original) && tryUnescape(line, originalEnd + 1, line.size(), entry.translation);
+		}
+
+		static bool tryParseNumber(const std::string & line, std::size_t first, std::size_t last, std::size_t & result)
+		{
+			if(first == last)
+				return false;
+
+			result = 0;
+
+			for(std::size_t index = first; index < last; ++index)
+			{
+				if((line[index] < '0') || (line[index] > '9'))
+					return false;
+
+				result = ((result * 10) + static_cast<std::size_t>(line[index] - '0'));
+			}
+
+			return true;
+		}
+
+		static bool tryUnescape(const std::string & line, std::size_t first, std::size_t last, std::string & result)
+		{
+			result.clear();
+
+			for(std::size_t index = first; index < last; ++index)
+			{
+				if(line[index] != '\\')
+				{
+					result += line[index];
+					continue;
+				}
+
+				++index;
+
+				if(index == last)
+					return false;
+
+				switch(line[index])
+				{
+				case '\\': result += '\\'; break;
+				case 't': result += '\t'; break;
+				case 'n': result += '\n'; break;
+				case 'r': result += '\r'; break;
+				default: return false;
+				}
+			}
+
+			return true;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <ostream>
+#include <string>
+
+#include "CatalogEntry.h"
+
+namespace VNVita
+{
+	// Writes a catalog one entry per line:
+	//
+	//   <script>:<line>.<part> TAB <original> TAB <translation>
+	//
+	// Backslashes, tabs and line breaks in the strings are escaped.
+	class CatalogWriter
+	{
+	private:
+		std::ostream & outputStream;
+
+	public:
+		CatalogWriter(std::ostream & outputStream) :
+			outputStream(outputStream)
+		{
+		}
+
+		void write(const CatalogEntry & entry)
+		{
+			this->outputStream << entry.scriptName << ':' << entry.line << '.' << entry.part << '\t';
+			this->writeEscaped(entry.original);
+			this->outputStream << '\t';
+			this->writeEscaped(entry.translation);
+			this->outputStream << '\n';
+		}
+
+	private:
+		void writeEscaped(const std::string & text)
+		{
+			std::size_t first = 0;
+
+			for(std::size_t index = 0; index < text.size(); ++index)
+			{
+				const char escape = getEscape(text[index]);
+
+				if(escape == '\0')
+					continue;
+
+				this->outputStream.write(text.data() + first, static_cast<std::streamsize>(index - first));
+				this->outputStream << '\\' << escape;
+				first = (index + 1);
+			}
+
+			this->outputStream.write(text.data() + first, static_cast<std::streamsize>(text.size() - first));
+		}
+
+		static char getEscape(char c)
+		{
+			switch(c)
+			{
+			case '\\': return '\\';
+			case '\t': return 't';
+			case '\n': return 'n';
+			case '\r': return 'r';
+			default: return '\0';
+			}
+		}
+	};
+}
\ No newline at end of file
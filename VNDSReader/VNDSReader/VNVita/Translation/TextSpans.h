@@ -0,0 +1,96 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../Commands.h"
+
+namespace VNVita
+{
+	// Where a translatable string sits in a source line
+	struct TextSpan
+	{
+		std::size_t first;
+		std::size_t length;
+	};
+
+	// Finds the translatable strings of one source line, given the command
+	// the Parser made of it. Spans are in order of part, so a choice's
+	// options are numbered from 0, empty options included.
+	//
+	// The spans are found in the line itself rather than taken from the
+	// command, so a string can be put back without touching the rest of
+	// the line, and so every option of a choice is found.
+	inline void findTextSpans(const std::string & line, const Command & command, std::vector<TextSpan> & spans)
+	{
+		const char * const delimiters = " \t\r";
+
+		spans.clear();
+
+		const bool isText = isa<TextCommand>(&command);
+		const bool isChoice = isa<ChoiceCommand>(&command);
+
+		if(!isText && !isChoice)
+			return;
+
+		// Skip the command name and the space after it
+		const auto nameFirst = line.find_first_not_of(delimiters);
+		const auto nameEnd = line.find_first_of(delimiters, nameFirst);
+		if(nameEnd == std::string::npos)
+			return;
+
+		std::size_t first = line.find_first_not_of(delimiters, nameEnd);
+		if(first == std::string::npos)
+			return;
+
+		std::size_t end = line.size();
+		if(line.back() == '\r')
+			--end;
+
+		if(isText)
+		{
+			// Clearing the text or waiting for input leave nothing to translate
+			if(((end - first) == 1) && ((line[first] == '~') || (line[first] == '!')))
+				return;
+
+			if(line[first] == '@')
+				++first;
+
+			if(first < end)
+				spans.push_back(TextSpan { first, end - first });
+
+			return;
+		}
+
+		while(true)
+		{
+			auto optionEnd = line.find('|', first);
+			if((optionEnd == std::string::npos) || (optionEnd > end))
+				optionEnd = end;
+
+			spans.push_back(TextSpan { first, optionEnd - first });
+
+			if(optionEnd == end)
+				break;
+
+			first = (optionEnd + 1);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "../Commands.h"
+
+#include "CatalogEntry.h"
+#include "CatalogWriter.h"
+#include "CatalogReader.h"
+#include "TextSpans.h"
+#include "CatalogExtractor.h"
+#include "CatalogInjector.h"
\ No newline at end of file
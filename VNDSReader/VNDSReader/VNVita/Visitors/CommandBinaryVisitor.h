@@ -0,0 +1,246 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "../Commands.h"
+#include "../Output/OutputBuffer.h"
+
+namespace VNVita
+{
+	// Writes commands in a compact binary form: the magic bytes "VNVB"
+	// and a format version, then every command as its CommandKind in one
+	// byte followed by its operands in the order their getters are
+	// declared. Every value is little endian whatever the machine:
+	//
+	//   int             4 bytes, two's complement
+	//   string          4 byte length, then the bytes
+	//   operation       1 byte, the SetOperation or IfOperation value
+	//   text option     1 byte, the TextOption value
+	//   choice list     4 byte count, then the strings
+	class CommandBinaryVisitor : public CommandVisitor
+	{
+	public:
+		static constexpr const char * magic = "VNVB";
+		static constexpr std::uint32_t version = 1;
+
+	private:
+		OutputBuffer output;
+
+	public:
+		CommandBinaryVisitor(std::ostream & outputStream) :
+			output(outputStream)
+		{
+			this->output.write(magic, 4);
+			this->writeUnsigned(version);
+		}
+
+		// Output is buffered until the visitor is destroyed or flushed
+		void flush()
+		{
+			this->output.flush();
+		}
+
+	private:
+		void writeByte(std::uint8_t value)
+		{
+			this->output.write(static_cast<char>(value));
+		}
+
+		void writeUnsigned(std::uint32_t value)
+		{
+			const char bytes[] =
+			{
+				static_cast<char>(value & 0xFF),
+				static_cast<char>((value >> 8) & 0xFF),
+				static_cast<char>((value >> 16) & 0xFF),
+				static_cast<char>((value >> 24) & 0xFF),
+			};
+
+			this->output.write(bytes, sizeof(bytes));
+		}
+
+		void writeInt(int value)
+		{
+			this->writeUnsigned(static_cast<std::uint32_t>(value));
+		}
+
+		void writeString(const std::string & text)
+		{
+			this->writeUnsigned(static_cast<std::uint32_t>(text.size()));
+			this->output.write(text);
+		}
+
+		void writeKind(const Command & command)
+		{
+			this->writeByte(static_cast<std::uint8_t>(command.getKind()));
+		}
+
+	protected:
+		virtual void visitSkipCommand(SkipCommand & skipCommand) override
+		{
+			this->writeKind(skipCommand);
+		}
+
+		virtual void visitEndScriptCommand(EndScriptCommand & endScriptCommand) override
+		{
+			this->writeKind(endScriptCommand);
+		}
+
+		virtual void visitBackgroundLoadCommand(BackgroundLoadCommand & backgroundLoadCommand) override
+		{
+			this->writeKind(backgroundLoadCommand);
+			this->writeString(backgroundLoadCommand.getPath());
+			this->writeInt(backgroundLoadCommand.getFadeTime());
+		}
+
+		virtual void visitSetImageCommand(SetImageCommand & setImageCommand) override
+		{
+			this->writeKind(setImageCommand);
+			this->writeString(setImageCommand.getPath());
+			this->writeInt(setImageCommand.getX());
+			this->writeInt(setImageCommand.getY());
+		}
+
+		virtual void visitChoiceCommand(ChoiceCommand & choiceCommand) override
+		{
+			this->writeKind(choiceCommand);
+
+			const auto & choices = choiceCommand.getChoices();
+			this->writeUnsigned(static_cast<std::uint32_t>(choices.size()));
+
+			for(const auto & choice : choices)
+				this->writeString(choice);
+		}
+
+		virtual void visitJumpCommand(JumpCommand & jumpCommand) override
+		{
+			this->writeKind(jumpCommand);
+			this->writeString(jumpCommand.getPath());
+			this->writeString(jumpCommand.getLabel());
+		}
+
+		virtual void visitDelayCommand(DelayCommand & delayCommand) override
+		{
+			this->writeKind(delayCommand);
+			this->writeInt(delayCommand.getTime());
+		}
+
+		virtual void visitRandomCommand(RandomCommand & randomCommand) override
+		{
+			this->writeKind(randomCommand);
+			this->writeString(randomCommand.getVariable());
+			this->writeInt(randomCommand.getLow());
+			this->writeInt(randomCommand.getHigh());
+		}
+
+		virtual void visitLabelCommand(LabelCommand & labelCommand) override
+		{
+			this->writeKind(labelCommand);
+			this->writeString(labelCommand.getLabel());
+		}
+
+		virtual void visitGoToCommand(GoToCommand & gotoCommand) override
+		{
+			this->writeKind(gotoCommand);
+			this->writeString(gotoCommand.getLabel());
+		}
+
+		virtual void visitClearTextCommand(ClearTextCommand & clearTextCommand) override
+		{
+			this->writeKind(clearTextCommand);
+		}
+
+		virtual void visitIfCommand(IfCommand & ifCommand) override
+		{
+			this->writeKind(ifCommand);
+			this->writeString(ifCommand.getLeft());
+			this->writeByte(static_cast<std::uint8_t>(ifCommand.getOperation()));
+			this->writeString(ifCommand.getRight());
+		}
+
+		virtual void visitFiCommand(FiCommand & fiCommand) override
+		{
+			this->writeKind(fiCommand);
+		}
+
+		virtual void visitAwaitInputCommand(AwaitInputCommand & awaitInputCommand) override
+		{
+			this->writeKind(awaitInputCommand);
+		}
+
+		virtual void visitTextCommand(TextCommand & textCommand) override
+		{
+			this->writeKind(textCommand);
+			this->writeString(textCommand.getText());
+			this->writeByte(static_cast<std::uint8_t>(textCommand.getOption()));
+		}
+
+		virtual void visitSetLocalVariableCommand(SetLocalVariableCommand & setLocalVariableCommand) override
+		{
+			this->writeKind(setLocalVariableCommand);
+			this->writeString(setLocalVariableCommand.getLeft());
+			this->writeByte(static_cast<std::uint8_t>(setLocalVariableCommand.getOperation()));
+			this->writeString(setLocalVariableCommand.getRight());
+		}
+
+		virtual void visitClearLocalVariablesCommand(ClearLocalVariablesCommand & clearLocalVariablesCommand) override
+		{
+			this->writeKind(clearLocalVariablesCommand);
+		}
+
+		virtual void visitSetGlobalVariableCommand(SetGlobalVariableCommand & setGlobalVariableCommand) override
+		{
+			this->writeKind(setGlobalVariableCommand);
+			this->writeString(setGlobalVariableCommand.getLeft());
+			this->writeByte(static_cast<std::uint8_t>(setGlobalVariableCommand.getOperation()));
+			this->writeString(setGlobalVariableCommand.getRight());
+		}
+
+		virtual void visitClearGlobalVariablesCommand(ClearGlobalVariablesCommand & clearGlobalVariablesCommand) override
+		{
+			this->writeKind(clearGlobalVariablesCommand);
+		}
+
+		virtual void visitPlayMusicCommand(PlayMusicCommand & playMusicCommand) override
+		{
+			this->writeKind(playMusicCommand);
+			this->writeString(playMusicCommand.getPath());
+		}
+
+		virtual void visitStopMusicCommand(StopMusicCommand & stopMusicCommand) override
+		{
+			this->writeKind(stopMusicCommand);
+		}
+
+		virtual void visitPlaySoundCommand(PlaySoundCommand & playSoundCommand) override
+		{
+			this->writeKind(playSoundCommand);
+			this->writeString(playSoundCommand.getPath());
+			this->writeInt(playSoundCommand.getRepeats());
+		}
+
+		virtual void visitStopSoundCommand(StopSoundCommand & stopSoundCommand) override
+		{
+			this->writeKind(stopSoundCommand);
+		}
+	};
+}
\ No newline at end of file
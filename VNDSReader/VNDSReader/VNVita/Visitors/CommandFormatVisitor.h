@@ -16,36 +16,61 @@
 //  limitations under the License.
 //
 
+#include <cstddef>
 #include <ostream>
+#include <string>
 
 #include "../Commands.h"
+#include "../Output/OutputBuffer.h"
 
 namespace VNVita
 {
 	class CommandFormatVisitor : public CommandVisitor
 	{
-	private:
+	public:
 		static constexpr const char * defaultIndent = "\t";
 
 	private:
-		std::ostream & outputStream;
+		OutputBuffer output;
 		int indentLevel = 0;
 		std::string indentString = defaultIndent;
 
+		// indentString repeated for the deepest indent so far,
+		// so any indent is written in one go
+		std::string indentRun;
+
 	public:
 		CommandFormatVisitor(std::ostream & outputStream) :
-			outputStream(outputStream)
+			output(outputStream)
 		{
 		}
 
 		CommandFormatVisitor(std::ostream & outputStream, const std::string & indentString) :
-			outputStream(outputStream), indentString(indentString)
+			output(outputStream), indentString(indentString)
 		{
 		}
 
 		CommandFormatVisitor(std::ostream & outputStream, std::string && indentString) :
-			outputStream(outputStream), indentString(indentString)
+			output(outputStream), indentString(indentString)
+		{
+		}
+
+		// Output is buffered until the visitor is destroyed or flushed
+		void flush()
 		{
+			this->output.flush();
+		}
+
+		int getIndentLevel() const
+		{
+			return this->indentLevel;
+		}
+
+		// For formatting commands from partway through a script,
+		// inside however many ifs are open at that point
+		void setIndentLevel(int indentLevel)
+		{
+			this->indentLevel = indentLevel;
 		}
 
 	private:
@@ -61,8 +86,15 @@ namespace VNVita
 
 		void writeIndent()
 		{
-			for(int i = 0; i < this->indentLevel; ++i)
-				this->outputStream << this->indentString;
+			if(this->indentLevel <= 0)
+				return;
+
+			const std::size_t length = (static_cast<std::size_t>(this->indentLevel) * this->indentString.size());
+
+			while(this->indentRun.size() < length)
+				this->indentRun += this->indentString;
+
+			this->output.write(this->indentRun.data(), length);
 		}
 
 		const char * toString(SetOperation operation)
@@ -105,14 +137,14 @@ namespace VNVita
 		virtual void visitSkipCommand(SkipCommand & skipCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "#" << '\n';
+			this->output.write("#\n");
 			static_cast<void>(skipCommand);
 		}
 
 		virtual void visitEndScriptCommand(EndScriptCommand & endScriptCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "endscript" << '\n';
+			this->output.write("endscript\n");
 			static_cast<void>(endScriptCommand);
 		}
 
@@ -121,19 +153,29 @@ namespace VNVita
 		{
 			this->writeIndent();
 
-			this->outputStream << "bgload " << backgroundLoadCommand.getPath();
+			this->output.write("bgload ");
+			this->output.write(backgroundLoadCommand.getPath());
 
 			if(backgroundLoadCommand.getFadeTime() >= 0)
-				this->outputStream << ' ' << backgroundLoadCommand.getFadeTime();
+			{
+				this->output.write(' ');
+				this->output.write(backgroundLoadCommand.getFadeTime());
+			}
 
-			this->outputStream << '\n';
+			this->output.write('\n');
 		}
 
 
 		virtual void visitSetImageCommand(SetImageCommand & setImageCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "setimg " << setImageCommand.getPath() << ' ' << setImageCommand.getX() << ' ' << setImageCommand.getY() << '\n';
+			this->output.write("setimg ");
+			this->output.write(setImageCommand.getPath());
+			this->output.write(' ');
+			this->output.write(setImageCommand.getX());
+			this->output.write(' ');
+			this->output.write(setImageCommand.getY());
+			this->output.write('\n');
 		}
 
 
@@ -141,17 +183,17 @@ namespace VNVita
 		{
 			this->writeIndent();
 
-			this->outputStream << "choice ";
+			this->output.write("choice ");
 
 			const auto & choices = choiceCommand.getChoices();
 			for(std::size_t index = 0; index < choices.size(); ++index)
 			{
 				if(index > 0)
-					this->outputStream << '|';
-				this->outputStream << choices[index];
+					this->output.write('|');
+				this->output.write(choices[index]);
 			}
 
-			this->outputStream << '\n';
+			this->output.write('\n');
 		}
 
 
@@ -159,47 +201,63 @@ namespace VNVita
 		{
 			this->writeIndent();
 
-			this->outputStream << "jump " << jumpCommand.getPath();
+			this->output.write("jump ");
+			this->output.write(jumpCommand.getPath());
 
 			if(jumpCommand.getLabel().size() > 0)
-				this->outputStream << ' ' << jumpCommand.getLabel();
+			{
+				this->output.write(' ');
+				this->output.write(jumpCommand.getLabel());
+			}
 
-			this->outputStream << '\n';
+			this->output.write('\n');
 		}
 
 
 		virtual void visitDelayCommand(DelayCommand & delayCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "delay " << delayCommand.getTime() << '\n';
+			this->output.write("delay ");
+			this->output.write(delayCommand.getTime());
+			this->output.write('\n');
 		}
 
 
 		virtual void visitRandomCommand(RandomCommand & randomCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "random " << randomCommand.getVariable() << ' ' << randomCommand.getLow() << ' ' << randomCommand.getHigh() << '\n';
+			this->output.write("random ");
+			this->output.write(randomCommand.getVariable());
+			this->output.write(' ');
+			this->output.write(randomCommand.getLow());
+			this->output.write(' ');
+			this->output.write(randomCommand.getHigh());
+			this->output.write('\n');
 		}
 
 
 		virtual void visitLabelCommand(LabelCommand & labelCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "label " << labelCommand.getLabel() << '\n';
+			this->output.write("label ");
+			this->output.write(labelCommand.getLabel());
+			this->output.write('\n');
 		}
 
 
 		virtual void visitGoToCommand(GoToCommand & gotoCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "goto " << gotoCommand.getLabel() << '\n';
+			this->output.write("goto ");
+			this->output.write(gotoCommand.getLabel());
+			this->output.write('\n');
 		}
 
 
 		virtual void visitClearTextCommand(ClearTextCommand & clearTextCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "cleartext" << '\n';
+			this->output.write("cleartext\n");
 			static_cast<void>(clearTextCommand);
 		}
 
@@ -207,7 +265,13 @@ namespace VNVita
 		virtual void visitIfCommand(IfCommand & ifCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "if " << ifCommand.getLeft() << ' ' << toString(ifCommand.getOperation()) << ' ' << ifCommand.getRight() << '\n';
+			this->output.write("if ");
+			this->output.write(ifCommand.getLeft());
+			this->output.write(' ');
+			this->output.write(toString(ifCommand.getOperation()));
+			this->output.write(' ');
+			this->output.write(ifCommand.getRight());
+			this->output.write('\n');
 			this->increaseIndent();
 		}
 
@@ -215,7 +279,7 @@ namespace VNVita
 		{
 			this->decreaseIndent();
 			this->writeIndent();
-			this->outputStream << "fi" << '\n';
+			this->output.write("fi\n");
 			static_cast<void>(fiCommand);
 		}
 
@@ -223,7 +287,7 @@ namespace VNVita
 		virtual void visitAwaitInputCommand(AwaitInputCommand & awaitInputCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "text !" << '\n';
+			this->output.write("text !\n");
 			static_cast<void>(awaitInputCommand);
 		}
 
@@ -232,60 +296,77 @@ namespace VNVita
 		{
 			this->writeIndent();
 
-			this->outputStream << "text ";
+			this->output.write("text ");
 
 			if(textCommand.getOption() == TextOption::None)
 			{
 				if(textCommand.getText().size() == 0)
-					this->outputStream << '~';
+					this->output.write('~');
 				else
-					this->outputStream << '@' << textCommand.getText();
+				{
+					this->output.write('@');
+					this->output.write(textCommand.getText());
+				}
 			}
 			else
 			{
-				this->outputStream << textCommand.getText();
+				this->output.write(textCommand.getText());
 			}
 
-			this->outputStream << '\n';
+			this->output.write('\n');
 		}
 
 
 		virtual void visitSetLocalVariableCommand(SetLocalVariableCommand & setLocalVariableCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "setvar " << setLocalVariableCommand.getLeft() << ' ' << toString(setLocalVariableCommand.getOperation()) << ' ' << setLocalVariableCommand.getRight() << '\n';
+			this->output.write("setvar ");
+			this->output.write(setLocalVariableCommand.getLeft());
+			this->output.write(' ');
+			this->output.write(toString(setLocalVariableCommand.getOperation()));
+			this->output.write(' ');
+			this->output.write(setLocalVariableCommand.getRight());
+			this->output.write('\n');
 		}
 
 		virtual void visitClearLocalVariablesCommand(ClearLocalVariablesCommand & clearLocalVariablesCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "setvar ~ ~" << '\n';
+			this->output.write("setvar ~ ~\n");
 		}
 
 
 		virtual void visitSetGlobalVariableCommand(SetGlobalVariableCommand & setGlobalVariableCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "gsetvar " << setGlobalVariableCommand.getLeft() << ' ' << toString(setGlobalVariableCommand.getOperation()) << ' ' << setGlobalVariableCommand.getRight() << '\n';
+			this->output.write("gsetvar ");
+			this->output.write(setGlobalVariableCommand.getLeft());
+			this->output.write(' ');
+			this->output.write(toString(setGlobalVariableCommand.getOperation()));
+			this->output.write(' ');
+			this->output.write(setGlobalVariableCommand.getRight());
+			this->output.write('\n');
 		}
 
 		virtual void visitClearGlobalVariablesCommand(ClearGlobalVariablesCommand & clearGlobalVariablesCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "gsetvar ~ ~" << '\n';
+			this->output.write("gsetvar ~ ~\n");
 		}
 
 
 		virtual void visitPlayMusicCommand(PlayMusicCommand & playMusicCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "music " << playMusicCommand.getPath() << '\n';
+			this->output.write("music ");
+			this->output.write(playMusicCommand.getPath());
+			this->output.write('\n');
 		}
 
 		virtual void visitStopMusicCommand(StopMusicCommand & stopMusicCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "music ~" << '\n';
+			this->output.write("music ~\n");
 		}
 
 
@@ -293,18 +374,22 @@ namespace VNVita
 		{
 			this->writeIndent();
 
-			this->outputStream << "sound " << playSoundCommand.getPath();
+			this->output.write("sound ");
+			this->output.write(playSoundCommand.getPath());
 
 			if(playSoundCommand.getRepeats() > 1) 
-				this->outputStream << ' ' << playSoundCommand.getRepeats();
+			{
+				this->output.write(' ');
+				this->output.write(playSoundCommand.getRepeats());
+			}
 
-			this->outputStream << '\n';			
+			this->output.write('\n');
 		}
 
 		virtual void visitStopSoundCommand(StopSoundCommand & stopSoundCommand) override
 		{
 			this->writeIndent();
-			this->outputStream << "sound ~" << '\n';
+			this->output.write("sound ~\n");
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,336 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "../Commands.h"
+#include "../Output/OutputBuffer.h"
+
+namespace VNVita
+{
+	// Writes one JSON object per command per line, with a "kind" member
+	// named after the CommandKind and a typed member per operand.
+	// Operations are written by name, text commands have a boolean
+	// "awaitInput" and a choice has an array of "choices".
+	class CommandJsonLinesVisitor : public CommandVisitor
+	{
+	private:
+		OutputBuffer output;
+
+	public:
+		CommandJsonLinesVisitor(std::ostream & outputStream) :
+			output(outputStream)
+		{
+		}
+
+		// Output is buffered until the visitor is destroyed or flushed
+		void flush()
+		{
+			this->output.flush();
+		}
+
+	private:
+		static const char * toString(SetOperation operation)
+		{
+			switch(operation)
+			{
+			case SetOperation::Assign:
+				return "Assign";
+			case SetOperation::Add:
+				return "Add";
+			case SetOperation::Subtract:
+				return "Subtract";
+			default:
+				return "";
+			}
+		}
+
+		static const char * toString(IfOperation operation)
+		{
+			switch(operation)
+			{
+			case IfOperation::Equals:
+				return "Equals";
+			case IfOperation::NotEquals:
+				return "NotEquals";
+			case IfOperation::GreaterThan:
+				return "GreaterThan";
+			case IfOperation::LessThan:
+				return "LessThan";
+			case IfOperation::GreaterThanEquals:
+				return "GreaterThanEquals";
+			case IfOperation::LessThanEquals:
+				return "LessThanEquals";
+			default:
+				return "";
+			}
+		}
+
+		// Scripts are written out byte for byte, only
+		// quotes, backslashes and control characters are escaped
+		void writeString(const std::string & text)
+		{
+			static const char hexDigits[] = "0123456789abcdef";
+
+			this->output.write('"');
+
+			std::size_t first = 0;
+
+			for(std::size_t index = 0; index < text.size(); ++index)
+			{
+				const unsigned char c = static_cast<unsigned char>(text[index]);
+
+				if((c >= 0x20) && (c != '"') && (c != '\\'))
+					continue;
+
+				this->output.write(text.data() + first, index - first);
+				first = (index + 1);
+
+				switch(c)
+				{
+				case '"': this->output.write("\\\""); break;
+				case '\\': this->output.write("\\\\"); break;
+				case '\n': this->output.write("\\n"); break;
+				case '\r': this->output.write("\\r"); break;
+				case '\t': this->output.write("\\t"); break;
+				default:
+					this->output.write("\\u00");
+					this->output.write(hexDigits[c >> 4]);
+					this->output.write(hexDigits[c & 0xF]);
+					break;
+				}
+			}
+
+			this->output.write(text.data() + first, text.size() - first);
+			this->output.write('"');
+		}
+
+		void writeName(const char * name)
+		{
+			this->output.write(",\"");
+			this->output.write(name);
+			this->output.write("\":");
+		}
+
+		void writeMember(const char * name, const std::string & value)
+		{
+			this->writeName(name);
+			this->writeString(value);
+		}
+
+		void writeMember(const char * name, const char * value)
+		{
+			this->writeName(name);
+			this->output.write('"');
+			this->output.write(value);
+			this->output.write('"');
+		}
+
+		void writeMember(const char * name, int value)
+		{
+			this->writeName(name);
+			this->output.write(value);
+		}
+
+		void writeMember(const char * name, bool value)
+		{
+			this->writeName(name);
+			this->output.write(value ? "true" : "false");
+		}
+
+	protected:
+		virtual void visitSkipCommand(SkipCommand & skipCommand) override
+		{
+			this->output.write("{\"kind\":\"Skip\"}\n");
+			static_cast<void>(skipCommand);
+		}
+
+		virtual void visitEndScriptCommand(EndScriptCommand & endScriptCommand) override
+		{
+			this->output.write("{\"kind\":\"EndScript\"}\n");
+			static_cast<void>(endScriptCommand);
+		}
+
+		virtual void visitBackgroundLoadCommand(BackgroundLoadCommand & backgroundLoadCommand) override
+		{
+			this->output.write("{\"kind\":\"BackgroundLoad\"");
+			this->writeMember("path", backgroundLoadCommand.getPath());
+			this->writeMember("fadeTime", backgroundLoadCommand.getFadeTime());
+			this->output.write("}\n");
+		}
+
+		virtual void visitSetImageCommand(SetImageCommand & setImageCommand) override
+		{
+			this->output.write("{\"kind\":\"SetImage\"");
+			this->writeMember("path", setImageCommand.getPath());
+			this->writeMember("x", setImageCommand.getX());
+			this->writeMember("y", setImageCommand.getY());
+			this->output.write("}\n");
+		}
+
+		virtual void visitChoiceCommand(ChoiceCommand & choiceCommand) override
+		{
+			this->output.write("{\"kind\":\"Choice\"");
+			this->output.write(",\"choices\":[");
+
+			const auto & choices = choiceCommand.getChoices();
+			for(std::size_t index = 0; index < choices.size(); ++index)
+			{
+				if(index > 0)
+					this->output.write(',');
+
+				this->writeString(choices[index]);
+			}
+
+			this->output.write(']');
+			this->output.write("}\n");
+		}
+
+		virtual void visitJumpCommand(JumpCommand & jumpCommand) override
+		{
+			this->output.write("{\"kind\":\"Jump\"");
+			this->writeMember("path", jumpCommand.getPath());
+			this->writeMember("label", jumpCommand.getLabel());
+			this->output.write("}\n");
+		}
+
+		virtual void visitDelayCommand(DelayCommand & delayCommand) override
+		{
+			this->output.write("{\"kind\":\"Delay\"");
+			this->writeMember("time", delayCommand.getTime());
+			this->output.write("}\n");
+		}
+
+		virtual void visitRandomCommand(RandomCommand & randomCommand) override
+		{
+			this->output.write("{\"kind\":\"Random\"");
+			this->writeMember("variable", randomCommand.getVariable());
+			this->writeMember("low", randomCommand.getLow());
+			this->writeMember("high", randomCommand.getHigh());
+			this->output.write("}\n");
+		}
+
+		virtual void visitLabelCommand(LabelCommand & labelCommand) override
+		{
+			this->output.write("{\"kind\":\"Label\"");
+			this->writeMember("label", labelCommand.getLabel());
+			this->output.write("}\n");
+		}
+
+		virtual void visitGoToCommand(GoToCommand & gotoCommand) override
+		{
+			this->output.write("{\"kind\":\"GoTo\"");
+			this->writeMember("label", gotoCommand.getLabel());
+			this->output.write("}\n");
+		}
+
+		virtual void visitClearTextCommand(ClearTextCommand & clearTextCommand) override
+		{
+			this->output.write("{\"kind\":\"ClearText\"}\n");
+			static_cast<void>(clearTextCommand);
+		}
+
+		virtual void visitIfCommand(IfCommand & ifCommand) override
+		{
+			this->output.write("{\"kind\":\"If\"");
+			this->writeMember("left", ifCommand.getLeft());
+			this->writeMember("operation", toString(ifCommand.getOperation()));
+			this->writeMember("right", ifCommand.getRight());
+			this->output.write("}\n");
+		}
+
+		virtual void visitFiCommand(FiCommand & fiCommand) override
+		{
+			this->output.write("{\"kind\":\"Fi\"}\n");
+			static_cast<void>(fiCommand);
+		}
+
+		virtual void visitAwaitInputCommand(AwaitInputCommand & awaitInputCommand) override
+		{
+			this->output.write("{\"kind\":\"AwaitInput\"}\n");
+			static_cast<void>(awaitInputCommand);
+		}
+
+		virtual void visitTextCommand(TextCommand & textCommand) override
+		{
+			this->output.write("{\"kind\":\"Text\"");
+			this->writeMember("text", textCommand.getText());
+			this->writeMember("awaitInput", (textCommand.getOption() == TextOption::AwaitInput));
+			this->output.write("}\n");
+		}
+
+		virtual void visitSetLocalVariableCommand(SetLocalVariableCommand & setLocalVariableCommand) override
+		{
+			this->output.write("{\"kind\":\"SetLocalVariable\"");
+			this->writeMember("left", setLocalVariableCommand.getLeft());
+			this->writeMember("operation", toString(setLocalVariableCommand.getOperation()));
+			this->writeMember("right", setLocalVariableCommand.getRight());
+			this->output.write("}\n");
+		}
+
+		virtual void visitClearLocalVariablesCommand(ClearLocalVariablesCommand & clearLocalVariablesCommand) override
+		{
+			this->output.write("{\"kind\":\"ClearLocalVariables\"}\n");
+			static_cast<void>(clearLocalVariablesCommand);
+		}
+
+		virtual void visitSetGlobalVariableCommand(SetGlobalVariableCommand & setGlobalVariableCommand) override
+		{
+			this->output.write("{\"kind\":\"SetGlobalVariable\"");
+			this->writeMember("left", setGlobalVariableCommand.getLeft());
+			this->writeMember("operation", toString(setGlobalVariableCommand.getOperation()));
+			this->writeMember("right", setGlobalVariableCommand.getRight());
+			this->output.write("}\n");
+		}
+
+		virtual void visitClearGlobalVariablesCommand(ClearGlobalVariablesCommand & clearGlobalVariablesCommand) override
+		{
+			this->output.write("{\"kind\":\"ClearGlobalVariables\"}\n");
+			static_cast<void>(clearGlobalVariablesCommand);
+		}
+
+		virtual void visitPlayMusicCommand(PlayMusicCommand & playMusicCommand) override
+		{
+			this->output.write("{\"kind\":\"PlayMusic\"");
+			this->writeMember("path", playMusicCommand.getPath());
+			this->output.write("}\n");
+		}
+
+		virtual void visitStopMusicCommand(StopMusicCommand & stopMusicCommand) override
+		{
+			this->output.write("{\"kind\":\"StopMusic\"}\n");
+			static_cast<void>(stopMusicCommand);
+		}
+
+		virtual void visitPlaySoundCommand(PlaySoundCommand & playSoundCommand) override
+		{
+			this->output.write("{\"kind\":\"PlaySound\"");
+			this->writeMember("path", playSoundCommand.getPath());
+			this->writeMember("repeats", playSoundCommand.getRepeats());
+			this->output.write("}\n");
+		}
+
+		virtual void visitStopSoundCommand(StopSoundCommand & stopSoundCommand) override
+		{
+			this->output.write("{\"kind\":\"StopSound\"}\n");
+			static_cast<void>(stopSoundCommand);
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,238 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "../Commands.h"
+
+namespace VNVita
+{
+	struct CommandStatistics
+	{
+		// Indexed by CommandKind
+		std::array<std::size_t, commandKindCount> kindCounts {};
+
+		// Of text commands. Characters are UTF-8 code points other than
+		// white space, so the space kept before the text isn't counted.
+		std::size_t textCharacterCount = 0;
+		std::size_t textWordCount = 0;
+
+		std::size_t maximumIfDepth = 0;
+
+		std::size_t getKindCount(CommandKind kind) const
+		{
+			return this->kindCounts[static_cast<std::size_t>(kind)];
+		}
+
+		std::size_t getCommandCount() const
+		{
+			std::size_t count = 0;
+
+			for(const auto kindCount : this->kindCounts)
+				count += kindCount;
+
+			return count;
+		}
+
+		// Adds the counts of another script, keeping the deepest nesting of the two
+		void add(const CommandStatistics & other)
+		{
+			for(std::size_t index = 0; index < this->kindCounts.size(); ++index)
+				this->kindCounts[index] += other.kindCounts[index];
+
+			this->textCharacterCount += other.textCharacterCount;
+			this->textWordCount += other.textWordCount;
+
+			if(other.maximumIfDepth > this->maximumIfDepth)
+				this->maximumIfDepth = other.maximumIfDepth;
+		}
+	};
+
+	// Counts the commands of a script by kind as they're visited
+	class CommandStatisticsVisitor : public CommandVisitor
+	{
+	private:
+		CommandStatistics statistics;
+		std::size_t ifDepth = 0;
+
+	public:
+		const CommandStatistics & getStatistics() const
+		{
+			return this->statistics;
+		}
+
+	private:
+		void count(const Command & command)
+		{
+			++this->statistics.kindCounts[static_cast<std::size_t>(command.getKind())];
+		}
+
+		void countText(const std::string & text)
+		{
+			bool isInWord = false;
+
+			for(const char c : text)
+			{
+				const bool isSpace = ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'));
+
+				if(isSpace)
+				{
+					isInWord = false;
+					continue;
+				}
+
+				if(!isInWord)
+					++this->statistics.textWordCount;
+
+				isInWord = true;
+
+				// Continuation bytes don't start a character
+				if((static_cast<unsigned char>(c) & 0xC0) != 0x80)
+					++this->statistics.textCharacterCount;
+			}
+		}
+
+	protected:
+		virtual void visitSkipCommand(SkipCommand & skipCommand) override
+		{
+			this->count(skipCommand);
+		}
+
+		virtual void visitEndScriptCommand(EndScriptCommand & endScriptCommand) override
+		{
+			this->count(endScriptCommand);
+		}
+
+		virtual void visitBackgroundLoadCommand(BackgroundLoadCommand & backgroundLoadCommand) override
+		{
+			this->count(backgroundLoadCommand);
+		}
+
+		virtual void visitSetImageCommand(SetImageCommand & setImageCommand) override
+		{
+			this->count(setImageCommand);
+		}
+
+		virtual void visitChoiceCommand(ChoiceCommand & choiceCommand) override
+		{
+			this->count(choiceCommand);
+		}
+
+		virtual void visitJumpCommand(JumpCommand & jumpCommand) override
+		{
+			this->count(jumpCommand);
+		}
+
+		virtual void visitDelayCommand(DelayCommand & delayCommand) override
+		{
+			this->count(delayCommand);
+		}
+
+		virtual void visitRandomCommand(RandomCommand & randomCommand) override
+		{
+			this->count(randomCommand);
+		}
+
+		virtual void visitLabelCommand(LabelCommand & labelCommand) override
+		{
+			this->count(labelCommand);
+		}
+
+		virtual void visitGoToCommand(GoToCommand & gotoCommand) override
+		{
+			this->count(gotoCommand);
+		}
+
+		virtual void visitClearTextCommand(ClearTextCommand & clearTextCommand) override
+		{
+			this->count(clearTextCommand);
+		}
+
+		virtual void visitIfCommand(IfCommand & ifCommand) override
+		{
+			this->count(ifCommand);
+
+			++this->ifDepth;
+
+			if(this->ifDepth > this->statistics.maximumIfDepth)
+				this->statistics.maximumIfDepth = this->ifDepth;
+		}
+
+		virtual void visitFiCommand(FiCommand & fiCommand) override
+		{
+			this->count(fiCommand);
+
+			// A stray fi doesn't take the depth below zero
+			if(this->ifDepth > 0)
+				--this->ifDepth;
+		}
+
+		virtual void visitAwaitInputCommand(AwaitInputCommand & awaitInputCommand) override
+		{
+			this->count(awaitInputCommand);
+		}
+
+		virtual void visitTextCommand(TextCommand & textCommand) override
+		{
+			this->count(textCommand);
+			this->countText(textCommand.getText());
+		}
+
+		virtual void visitSetLocalVariableCommand(SetLocalVariableCommand & setLocalVariableCommand) override
+		{
+			this->count(setLocalVariableCommand);
+		}
+
+		virtual void visitClearLocalVariablesCommand(ClearLocalVariablesCommand & clearLocalVariablesCommand) override
+		{
+			this->count(clearLocalVariablesCommand);
+		}
+
+		virtual void visitSetGlobalVariableCommand(SetGlobalVariableCommand & setGlobalVariableCommand) override
+		{
+			this->count(setGlobalVariableCommand);
+		}
+
+		virtual void visitClearGlobalVariablesCommand(ClearGlobalVariablesCommand & clearGlobalVariablesCommand) override
+		{
+			this->count(clearGlobalVariablesCommand);
+		}
+
+		virtual void visitPlayMusicCommand(PlayMusicCommand & playMusicCommand) override
+		{
+			this->count(playMusicCommand);
+		}
+
+		virtual void visitStopMusicCommand(StopMusicCommand & stopMusicCommand) override
+		{
+			this->count(stopMusicCommand);
+		}
+
+		virtual void visitPlaySoundCommand(PlaySoundCommand & playSoundCommand) override
+		{
+			this->count(playSoundCommand);
+		}
+
+		virtual void visitStopSoundCommand(StopSoundCommand & stopSoundCommand) override
+		{
+			this->count(stopSoundCommand);
+		}
+	};
+}
\ No newline at end of file
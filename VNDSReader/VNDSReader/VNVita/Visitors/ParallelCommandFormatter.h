@@ -0,0 +1,156 @@
+#pragma once
+
+//
+//  Copyright (C) 2019 Pharap (@Pharap)
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../Commands.h"
+#include "../Parallel.h"
+#include "CommandFormatVisitor.h"
+
+namespace VNVita
+{
+	// Formats commands into exactly what a single CommandFormatVisitor
+	// would write, with the commands split into chunks formatted on
+	// several threads.
+	//
+	// A chunk's starting indent is the number of ifs less the number of
+	// fis before it. That is a prefix sum: the threads first total the
+	// change in indent over each chunk, a scan over those totals gives
+	// every chunk its starting indent, and then each chunk is formatted
+	// into a buffer of its own. The buffers are written out in order.
+	class ParallelCommandFormatter
+	{
+	public:
+		static constexpr std::size_t defaultChunkSize = 8192;
+
+	private:
+		std::size_t threadCount;
+		std::size_t chunkSize;
+		std::string indentString = CommandFormatVisitor::defaultIndent;
+
+	public:
+		// threadCount 0 uses every hardware thread
+		ParallelCommandFormatter(std::size_t threadCount = 0, std::size_t chunkSize = defaultChunkSize) :
+			threadCount(getThreadCount(threadCount)), chunkSize((chunkSize > 0) ? chunkSize : 1)
+		{
+		}
+
+		ParallelCommandFormatter(std::size_t threadCount, std::size_t chunkSize, const std::string & indentString) :
+			ParallelCommandFormatter(threadCount, chunkSize)
+		{
+			this->indentString = indentString;
+		}
+
+		void format(const std::vector<std::shared_ptr<Command>> & commands, std::ostream & outputStream) const
+		{
+			const std::size_t chunkCount = ((commands.size() + this->chunkSize - 1) / this->chunkSize);
+
+			// Not worth the threads
+			if((chunkCount < 2) || (this->threadCount < 2))
+			{
+				CommandFormatVisitor formatter(outputStream, this->indentString);
+
+				for(const auto & command : commands)
+					formatter.visit(*command);
+
+				return;
+			}
+
+			// The change in indent over each chunk, then the indent it starts at
+			std::vector<int> indents(chunkCount);
+
+			this->forEachChunk(chunkCount, [this, &commands, &indents](std::size_t chunk)
+			{
+				indents[chunk] = getIndentChange(commands, this->getFirst(chunk), this->getLast(chunk, commands.size()));
+			});
+
+			int indent = 0;
+
+			for(auto & chunkIndent : indents)
+			{
+				const int change = chunkIndent;
+				chunkIndent = indent;
+				indent += change;
+			}
+
+			std::vector<std::string> outputs(chunkCount);
+
+			this->forEachChunk(chunkCount, [this, &commands, &indents, &outputs](std::size_t chunk)
+			{
+				std::ostringstream stream;
+
+				{
+					CommandFormatVisitor formatter(stream, this->indentString);
+					formatter.setIndentLevel(indents[chunk]);
+
+					const std::size_t last = this->getLast(chunk, commands.size());
+
+					for(std::size_t index = this->getFirst(chunk); index < last; ++index)
+						formatter.visit(*commands[index]);
+				}
+
+				outputs[chunk] = stream.str();
+			});
+
+			for(const auto & output : outputs)
+				outputStream.write(output.data(), static_cast<std::streamsize>(output.size()));
+		}
+
+	private:
+		std::size_t getFirst(std::size_t chunk) const
+		{
+			return (chunk * this->chunkSize);
+		}
+
+		std::size_t getLast(std::size_t chunk, std::size_t commandCount) const
+		{
+			return (std::min)((chunk + 1) * this->chunkSize, commandCount);
+		}
+
+		// A stray fi takes the indent below zero just as it does in
+		// CommandFormatVisitor, so the sum isn't clamped either
+		static int getIndentChange(const std::vector<std::shared_ptr<Command>> & commands, std::size_t first, std::size_t last)
+		{
+			int change = 0;
+
+			for(std::size_t index = first; index < last; ++index)
+			{
+				const CommandKind kind = commands[index]->getKind();
+
+				if(kind == CommandKind::If)
+					++change;
+				else if(kind == CommandKind::Fi)
+					--change;
+			}
+
+			return change;
+		}
+
+		template<typename Function>
+		void forEachChunk(std::size_t chunkCount, Function function) const
+		{
+			forEachInParallel(chunkCount, this->threadCount, function);
+		}
+	};
+}
\ No newline at end of file
@@ -2,4 +2,8 @@
 
 #include "../Commands.h"
 
-#include "CommandFormatVisitor.h"
\ No newline at end of file
+#include "CommandFormatVisitor.h"
+#include "ParallelCommandFormatter.h"
+#include "CommandStatisticsVisitor.h"
+#include "CommandJsonLinesVisitor.h"
+#include "CommandBinaryVisitor.h"
\ No newline at end of file